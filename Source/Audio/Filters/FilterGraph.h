@@ -212,8 +212,9 @@ public:
 	{
 		AudioProcessor* processor;
 		const bool isCabbageFile = CabbageUtilities::hasCabbageTags(File(filename));
-		const int numChannels = CabbageUtilities::getHeaderInfo(filename, "nchnls");
-		const int sampleRate = CabbageUtilities::getHeaderInfo(filename, "sr");
+		const CsdDocument::Ptr csd = CsdDocument::forFile(File(filename));
+		const int numChannels = csd->getHeaderInfo("nchnls");
+		const int sampleRate = csd->getHeaderInfo("sr");
 
 		if (isCabbageFile)
 			processor = new CabbagePluginProcessor(File(filename), numChannels, numChannels);
@@ -0,0 +1,128 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEAUDIOTAP_H_INCLUDED
+#define CABBAGEAUDIOTAP_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Lets scope widgets look at the plugin's audio without any analysis running in Csound.
+// A tap names its source as "input:N" or "output:N", for channel N of the plugin's input
+// or output bus, or as the name of an a-rate channel. The processor copies that source into
+// the tap's ring every block, but only while at least one reader holds the tap. Readers
+// take a snapshot of the newest samples and never move anything the writer depends on, so
+// any number of them can share a tap from any thread. A snapshot the writer overtook while
+// it was being copied is reported as failed instead of being handed back torn.
+//==============================================================================
+class CabbageAudioTap
+{
+public:
+    enum SourceType
+    {
+        inputBus,
+        outputBus,
+        audioChannel
+    };
+
+    CabbageAudioTap (const String& tapSource, int ringSize = 32768)
+        : source (tapSource),
+          capacity (nextPowerOfTwo (ringSize)),
+          ring ((size_t) capacity, true)
+    {
+        const String type (source.upToFirstOccurrenceOf (":", false, false).trim());
+
+        if (type == "input" || type == "output")
+        {
+            sourceType = type == "input" ? inputBus : outputBus;
+            busChannel = jmax (1, source.fromFirstOccurrenceOf (":", false, false).getIntValue()) - 1;
+        }
+        else
+        {
+            sourceType = audioChannel;
+            channelName = source.trim();
+        }
+    }
+
+    const String& getSource() const noexcept        { return source; }
+    SourceType getSourceType() const noexcept       { return sourceType; }
+    int getBusChannel() const noexcept              { return busChannel; }
+    const String& getChannelName() const noexcept   { return channelName; }
+    int getCapacity() const noexcept                { return capacity; }
+
+    //readers are counted so the processor can skip taps nobody is looking at
+    void addReader() noexcept                       { ++numReaders; }
+    void removeReader() noexcept                    { --numReaders; }
+    bool isActive() const noexcept                  { return numReaders.get() > 0; }
+
+    //audio thread only
+    template <typename SampleType>
+    void push (const SampleType* data, int numSamples, SampleType scale = SampleType (1)) noexcept
+    {
+        const int64 start = writePosition.get();
+
+        for (int i = 0; i < numSamples; ++i)
+            ring[(int) ((start + i) & (capacity - 1))] = float (data[i] * scale);
+
+        writePosition.set (start + numSamples);
+    }
+
+    //the total number of samples pushed so far
+    int64 getWritePosition() const noexcept         { return writePosition.get(); }
+
+    //copies the newest numSamples into dest, returns the write position the snapshot ends
+    //at, or -1 if not enough has been written yet or the writer overtook the copy
+    int64 readLatest (float* dest, int numSamples) const noexcept
+    {
+        return read (dest, numSamples, writePosition.get());
+    }
+
+    //as readLatest(), but the snapshot ends at a given write position
+    int64 read (float* dest, int numSamples, int64 end) const noexcept
+    {
+        jassert (numSamples <= capacity / 2);
+        const int64 start = end - numSamples;
+
+        if (start < 0)
+            return -1;
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = ring[(int) ((start + i) & (capacity - 1))];
+
+        if (writePosition.get() - start > capacity)
+            return -1;
+
+        return end;
+    }
+
+private:
+    const String source;
+    SourceType sourceType = audioChannel;
+    int busChannel = 0;
+    String channelName;
+
+    const int capacity;
+    HeapBlock<float> ring;
+    Atomic<int64> writePosition;
+    Atomic<int> numReaders;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageAudioTap)
+};
+
+#endif  // CABBAGEAUDIOTAP_H_INCLUDED
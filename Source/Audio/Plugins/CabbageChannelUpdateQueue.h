@@ -0,0 +1,158 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGECHANNELUPDATEQUEUE_H_INCLUDED
+#define CABBAGECHANNELUPDATEQUEUE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <csound.h>
+
+//==============================================================================
+// Holds control channel updates coming in from the host, or the editor, until the
+// audio thread applies them at the next k-boundary. Each channel index has its own
+// value slot and a pending bit, so repeated writes to the same channel before the next
+// k-cycle coalesce into one. Values are kept as MYFLT, so a queued update reaches Csound
+// exactly as a direct channel write would. Pushing and draining are both wait-free, and
+// any number of threads may push. Slots are allocated in blocks that never move, so the
+// message thread can grow the queue along with the channel table while other threads
+// are pushing.
+// Indices beyond the current capacity are rejected and counted as drops.
+//==============================================================================
+class CabbageChannelUpdateQueue
+{
+public:
+    enum
+    {
+        channelsPerBlock = 4096,
+        maxNumBlocks = 256
+    };
+
+    CabbageChannelUpdateQueue (int initialNumChannels = channelsPerBlock)
+    {
+        ensureCapacity (initialNumChannels);
+    }
+
+    ~CabbageChannelUpdateQueue()
+    {
+        for (int i = 0; i < maxNumBlocks; i++)
+            delete blocks[i].get();
+    }
+
+    //message thread, makes room for channel indices up to numChannels - 1
+    void ensureCapacity (int numChannels)
+    {
+        const int numBlocks = jmin ((int) maxNumBlocks, (numChannels + channelsPerBlock - 1) / channelsPerBlock);
+
+        for (int i = capacity.get() / channelsPerBlock; i < numBlocks; i++)
+        {
+            blocks[i].set (new Block());
+            capacity.set ((i + 1) * channelsPerBlock);
+        }
+    }
+
+    //can be called from any thread
+    bool push (int channelIndex, MYFLT value) noexcept
+    {
+        if (! isPositiveAndBelow (channelIndex, capacity.get()))
+        {
+            ++numDropped;
+            return false;
+        }
+
+        Block& block = *blocks[channelIndex / channelsPerBlock].get();
+        const int slot = channelIndex % channelsPerBlock;
+        block.values[slot].set (value);
+
+        const uint32 bit = 1u << (slot & 31);
+        Atomic<uint32>& word = block.pendingBits[slot >> 5];
+
+        if ((word.value.fetch_or (bit) & bit) == 0)
+        {
+            raiseTo (peakDepth, ++numPending);
+            raiseTo (numWordsInUse, (channelIndex >> 5) + 1);
+        }
+        else
+            ++numCoalesced;
+
+        return true;
+    }
+
+    //audio thread only, calls applyUpdate (channelIndex, value) for every pending channel
+    template <typename UpdateFunction>
+    void drain (UpdateFunction applyUpdate) noexcept
+    {
+        if (numPending.get() == 0)
+            return;
+
+        const int wordsToScan = numWordsInUse.get();
+
+        for (int w = 0; w < wordsToScan; w++)
+        {
+            Block& block = *blocks[w / wordsPerBlock].get();
+            uint32 bits = block.pendingBits[w % wordsPerBlock].exchange (0);
+
+            while (bits != 0)
+            {
+                const int bitIndex = countNumberOfBits ((bits & (0u - bits)) - 1u);
+                bits &= bits - 1;
+
+                const int channelIndex = (w << 5) + bitIndex;
+                applyUpdate (channelIndex, block.values[channelIndex % channelsPerBlock].get());
+                --numPending;
+            }
+        }
+    }
+
+    int getCapacity() const noexcept                { return capacity.get(); }
+    int getNumPending() const noexcept              { return numPending.get(); }
+    int getPeakDepth() const noexcept               { return peakDepth.get(); }
+    int getNumDropped() const noexcept              { return numDropped.get(); }
+    int getNumCoalesced() const noexcept            { return numCoalesced.get(); }
+
+    void resetCounters() noexcept
+    {
+        peakDepth.set (numPending.get());
+        numDropped.set (0);
+        numCoalesced.set (0);
+    }
+
+private:
+    enum { wordsPerBlock = channelsPerBlock / 32 };
+
+    struct Block
+    {
+        Atomic<MYFLT> values[channelsPerBlock];
+        Atomic<uint32> pendingBits[wordsPerBlock];
+    };
+
+    static void raiseTo (Atomic<int>& maximum, int newValue) noexcept
+    {
+        for (int current = maximum.get(); newValue > current; current = maximum.get())
+            if (maximum.compareAndSetBool (newValue, current))
+                return;
+    }
+
+    Atomic<Block*> blocks[maxNumBlocks];
+    Atomic<int> capacity { 0 };
+    Atomic<int> numPending { 0 }, peakDepth { 0 }, numDropped { 0 }, numCoalesced { 0 }, numWordsInUse { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageChannelUpdateQueue)
+};
+
+#endif  // CABBAGECHANNELUPDATEQUEUE_H_INCLUDED
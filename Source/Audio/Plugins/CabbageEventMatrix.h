@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEEVENTMATRIX_H_INCLUDED
+#define CABBAGEEVENTMATRIX_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <csound.h>
+#include "../../Utilities/CsdDocument.h"
+
+//==============================================================================
+// Event sequencer cells compiled into score events. It is built on the message
+// thread, one sequencer at a time, one step at a time, and then only read by the
+// audio thread, which watches each sequencer's position channel and sends the
+// events for a step when the position moves onto it. Cells made up of a statement
+// type and numeric p-fields, i.e, "i1 0 .5 60", are stored as p-field arrays that
+// go straight to csoundScoreEvent(). Anything else, string p-fields or score
+// shorthand, is kept as text and passed to Csound to parse.
+//==============================================================================
+class CabbageEventMatrix
+{
+public:
+    CabbageEventMatrix() {}
+
+    //everything added after this belongs to the new sequencer
+    void addSequencer (int positionChannel)
+    {
+        Sequencer sequencer;
+        sequencer.positionChannel = positionChannel;
+        sequencer.stepStarts.add (events.size());
+        sequencers.add (sequencer);
+    }
+
+    //closes the current step, events added after this go to the next one
+    void endStep()
+    {
+        jassert (sequencers.size() > 0);
+        sequencers.getReference (sequencers.size() - 1).stepStarts.add (events.size());
+    }
+
+    void addEvent (const String& cellText)
+    {
+        const String text = cellText.trim();
+
+        if (text.isEmpty())
+            return;
+
+        ScoreEvent event;
+        event.firstPField = pFields.size();
+
+        if (compileScoreEvent (text, event.type, pFields))
+        {
+            event.numPFields = pFields.size() - event.firstPField;
+            event.startDelay = event.numPFields > 1 ? jmax (0.0, (double) pFields[event.firstPField + 1]) : 0.0;
+        }
+        else
+        {
+            pFields.removeRange (event.firstPField, pFields.size() - event.firstPField);
+            event.textIndex = textEvents.size();
+            event.startDelay = CsdDocument::getLastEventTime (text);
+            textEvents.add (text);
+        }
+
+        events.add (event);
+    }
+
+    //keeps sequencers that were already playing on their current step, so swapping
+    //in a newly compiled matrix doesn't retrigger it
+    void carryPositionsFrom (const CabbageEventMatrix& other)
+    {
+        for (auto& sequencer : sequencers)
+            for (auto& previous : other.sequencers)
+                if (previous.positionChannel == sequencer.positionChannel)
+                    sequencer.lastPosition = previous.lastPosition;
+    }
+
+    //called on each k-cycle by the audio thread. getPosition (channelIndex) returns a
+    //sequencer's current step, sendScoreEvent (type, pFields, numPFields) and
+    //sendTextEvent (const char*) pass events on to Csound. Returns how far ahead, in seconds,
+    //the latest of the events sent starts
+    template <typename PositionFunction, typename ScoreEventFunction, typename TextEventFunction>
+    double triggerChangedSteps (PositionFunction getPosition, ScoreEventFunction sendScoreEvent, TextEventFunction sendTextEvent)
+    {
+        double startDelay = 0.0;
+
+        for (auto& sequencer : sequencers)
+        {
+            const int position = getPosition (sequencer.positionChannel);
+
+            if (position == sequencer.lastPosition)
+                continue;
+
+            sequencer.lastPosition = position;
+
+            if (! isPositiveAndBelow (position, sequencer.stepStarts.size() - 1))
+                continue;
+
+            for (int i = sequencer.stepStarts.getUnchecked (position); i < sequencer.stepStarts.getUnchecked (position + 1); i++)
+            {
+                const ScoreEvent& event = events.getReference (i);
+
+                if (event.textIndex >= 0)
+                    sendTextEvent (textEvents[event.textIndex].toRawUTF8());
+                else
+                    sendScoreEvent (event.type, pFields.begin() + event.firstPField, (long) event.numPFields);
+
+                startDelay = jmax (startDelay, event.startDelay);
+            }
+        }
+
+        return startDelay;
+    }
+
+    int getNumSequencers() const       { return sequencers.size(); }
+    int getNumEvents() const           { return events.size(); }
+    int getNumTextEvents() const       { return textEvents.size(); }
+
+    //parses "i1 0 1 440" or "i 1 0 1 440" into a type and p-fields, returns false if
+    //the statement can't be sent without Csound's score parser
+    static bool compileScoreEvent (const String& text, char& type, Array<MYFLT>& pFieldsToAddTo)
+    {
+        const String statementTypes ("aifqe");
+
+        if (text.isEmpty() || ! statementTypes.containsChar (text[0]))
+            return false;
+
+        type = (char) text[0];
+
+        StringArray tokens;
+        tokens.addTokens (text.substring (1), " \t", "");
+        tokens.removeEmptyStrings();
+
+        for (auto& token : tokens)
+        {
+            //rejects score shorthand such as carry (.), ramps (<) and expressions ([...])
+            if (! token.containsOnly ("0123456789.-+eE") || ! token.containsAnyOf ("0123456789"))
+                return false;
+
+            pFieldsToAddTo.add ((MYFLT) token.getDoubleValue());
+        }
+
+        return tokens.size() > 0 || type == 'e';
+    }
+
+private:
+    struct ScoreEvent
+    {
+        char type = 'i';
+        int firstPField = 0, numPFields = 0;
+        int textIndex = -1;
+        double startDelay = 0.0;
+    };
+
+    struct Sequencer
+    {
+        int positionChannel = -1;
+        int lastPosition = 0;
+        //step n's events run from stepStarts[n] up to stepStarts[n + 1]
+        Array<int> stepStarts;
+    };
+
+    Array<Sequencer> sequencers;
+    Array<ScoreEvent> events;
+    Array<MYFLT> pFields;
+    StringArray textEvents;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageEventMatrix)
+};
+
+#endif  // CABBAGEEVENTMATRIX_H_INCLUDED
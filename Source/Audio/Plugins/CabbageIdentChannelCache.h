@@ -0,0 +1,148 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEIDENTCHANNELCACHE_H_INCLUDED
+#define CABBAGEIDENTCHANNELCACHE_H_INCLUDED
+
+#include "../../Widgets/CabbageWidgetData.h"
+#include "../../Widgets/CabbageLineLexer.h"
+
+//==============================================================================
+// Remembers what the last few identchannel messages sent to one widget did to it. Instruments
+// often send the same handful of strings every k-cycle, so a message seen before isn't parsed
+// again: the properties it set are applied straight from the cache, and only the ones whose
+// value has actually changed are written, which keeps ValueTree listeners quiet. Identifiers
+// that build on the widget's current state, like tablecolour:N, are parsed every time.
+//==============================================================================
+class CabbageIdentChannelCache
+{
+public:
+    void apply (ValueTree widget, const String& message)
+    {
+        for (int i = 0; i < numEntries; i++)
+        {
+            //try the last message first, it is by far the most likely to come round again
+            Entry& entry = entries[(lastApplied + i) % numEntries];
+
+            if (entry.message == message)
+            {
+                entry.lastUsed = ++useCount;
+                lastApplied = (int) (&entry - entries);
+                applyProperties (widget, entry.properties);
+                return;
+            }
+        }
+
+        if (! isCacheable (message))
+        {
+            CabbageWidgetData::setCustomWidgetState (widget, " " + message);
+            return;
+        }
+
+        //parse into an empty widget of the same type, whatever it ends up holding is what the message sets
+        ValueTree parsed (widget.getType());
+        parsed.setProperty (CabbageIdentifierIds::type, widget.getProperty (CabbageIdentifierIds::type), nullptr);
+        parsed.setProperty (CabbageIdentifierIds::channeltype, widget.getProperty (CabbageIdentifierIds::channeltype), nullptr);
+        CabbageWidgetData::setCustomWidgetState (parsed, " " + message);
+
+        Entry& entry = getFreeEntry();
+        entry.message = message;
+        entry.properties.clear();
+        entry.lastUsed = ++useCount;
+        lastApplied = (int) (&entry - entries);
+
+        for (int i = 0; i < parsed.getNumProperties(); i++)
+        {
+            const Identifier name (parsed.getPropertyName (i));
+            const var& value = parsed.getProperty (name);
+
+            if ((name != CabbageIdentifierIds::type && name != CabbageIdentifierIds::channeltype) || value != widget.getProperty (name))
+                entry.properties.set (name, value);
+        }
+
+        applyProperties (widget, entry.properties);
+    }
+
+    void clear()
+    {
+        numEntries = lastApplied = 0;
+    }
+
+private:
+    struct Entry
+    {
+        String message;
+        NamedValueSet properties;
+        uint32 lastUsed = 0;
+    };
+
+    static void applyProperties (ValueTree& widget, const NamedValueSet& properties)
+    {
+        for (auto& property : properties)
+            if (widget.getProperty (property.name) != property.value)
+                CabbageWidgetData::setProperty (widget, property.name, property.value);
+    }
+
+    static bool isCacheable (const String& message)
+    {
+        CabbageLineLexer identifiers (message);
+
+        while (identifiers.next())
+        {
+            switch (identifiers.getHash())
+            {
+                case HashStringToInt ("amprange"):
+                case HashStringToInt ("tablecolour"):
+                case HashStringToInt ("tablecolours"):
+                case HashStringToInt ("tablecolour:"):
+                case HashStringToInt ("metercolour"):
+                case HashStringToInt ("metercolour:"):
+                case HashStringToInt ("rowprefix"):
+                case HashStringToInt ("colprefix"):
+                    return false;
+
+                default:
+                    break;
+            }
+        }
+
+        return true;
+    }
+
+    Entry& getFreeEntry()
+    {
+        if (numEntries < maxEntries)
+            return entries[numEntries++];
+
+        Entry* oldest = entries;
+
+        for (auto& entry : entries)
+            if (entry.lastUsed < oldest->lastUsed)
+                oldest = &entry;
+
+        return *oldest;
+    }
+
+    enum { maxEntries = 8 };
+    Entry entries[maxEntries];
+    int numEntries = 0, lastApplied = 0;
+    uint32 useCount = 0;
+};
+
+#endif  // CABBAGEIDENTCHANNELCACHE_H_INCLUDED
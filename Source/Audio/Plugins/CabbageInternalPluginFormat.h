@@ -61,13 +61,13 @@ public:
 
 	GenericCabbagePluginProcessor* createGenericPluginFilter(File inputFile)
 	{
-		const int numChannels = CabbageUtilities::getHeaderInfo(inputFile.loadFileAsString(), "nchnls");
+		const int numChannels = CsdDocument::forFile(inputFile)->getHeaderInfo("nchnls");
 		return new GenericCabbagePluginProcessor(inputFile, numChannels, numChannels);
 	}
 
 	CabbagePluginProcessor* createCabbagePluginFilter(File inputFile)
 	{
-		const int numChannels = CabbageUtilities::getHeaderInfo(inputFile.loadFileAsString(), "nchnls");
+		const int numChannels = CsdDocument::forFile(inputFile)->getHeaderInfo("nchnls");
 		return new CabbagePluginProcessor(inputFile, numChannels, numChannels);
 	}
 
@@ -0,0 +1,155 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEMETERENGINE_H_INCLUDED
+#define CABBAGEMETERENGINE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Peak, RMS and true peak levels for every channel of the plugin's input and output buses,
+// measured on the audio thread and published through atomics that meter widgets read at
+// their own pace. A bus is only measured while at least one meter is bound to it.
+//
+// Peaks rise instantly and fall 20dB in about 1.7 seconds, as a programme peak meter does.
+// RMS is integrated over 300ms. True peak runs the same ballistics on the signal
+// interpolated to four times the sample rate, which catches the overs that sit between samples.
+//==============================================================================
+class CabbageMeterEngine
+{
+public:
+    enum Bus
+    {
+        inputBus,
+        outputBus,
+        numBuses
+    };
+
+    enum { maxChannelsPerBus = 32 };
+
+    struct Levels
+    {
+        Atomic<float> peak, rms, truePeak;
+    };
+
+    CabbageMeterEngine()
+    {
+        //windowed sinc taps for the three points between each pair of samples
+        for (int phase = 0; phase < numPhases; ++phase)
+        {
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const double x = tap - (numTaps / 2 - 1) - (phase + 1) / double (numPhases + 1);
+                const double sinc = x == 0 ? 1.0 : std::sin (double_Pi * x) / (double_Pi * x);
+                const double window = 0.5 + 0.5 * std::cos (double_Pi * x / (numTaps / 2));
+                coefficients[phase][tap] = float (sinc * window);
+            }
+        }
+    }
+
+    //call while audio is stopped
+    void prepare (double newSampleRate)
+    {
+        sampleRate = jmax (1.0, newSampleRate);
+    }
+
+    //message thread, a bus is measured for as long as it has readers
+    Levels* addReader (Bus bus, int channel)
+    {
+        if (! isPositiveAndBelow (channel, (int) maxChannelsPerBus))
+            return nullptr;
+
+        ++numReaders[bus];
+        return &channels[bus][channel].levels;
+    }
+
+    void removeReader (Bus bus)                             { --numReaders[bus]; }
+    bool isActive (Bus bus) const noexcept                  { return numReaders[bus].get() > 0; }
+
+    //audio thread
+    void process (Bus bus, const AudioBuffer<float>& buffer, int numChannels) noexcept
+    {
+        const int numSamples = buffer.getNumSamples();
+
+        if (numSamples == 0)
+            return;
+
+        const double peakFallTime = 0.74;   //seconds for a peak to fall by 1/e
+        const double rmsTime = 0.3;
+        const float peakFall = (float) std::exp (-numSamples / (sampleRate * peakFallTime));
+        const float rmsSmoothing = (float) std::exp (-numSamples / (sampleRate * rmsTime));
+
+        for (int channel = 0; channel < jmin (numChannels, (int) maxChannelsPerBus); ++channel)
+        {
+            ChannelState& state = channels[bus][channel];
+            const float* const data = buffer.getReadPointer (channel);
+            float blockPeak = 0, blockTruePeak = 0, sumOfSquares = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float sample = data[i];
+                blockPeak = jmax (blockPeak, std::abs (sample));
+                sumOfSquares += sample * sample;
+
+                //the history is written twice so the newest numTaps samples are always contiguous
+                state.history[state.historyIndex] = state.history[state.historyIndex + numTaps] = sample;
+                state.historyIndex = (state.historyIndex + 1) % numTaps;
+                const float* const window = state.history + state.historyIndex;
+
+                for (int phase = 0; phase < numPhases; ++phase)
+                {
+                    float interpolated = 0;
+
+                    for (int tap = 0; tap < numTaps; ++tap)
+                        interpolated += window[tap] * coefficients[phase][tap];
+
+                    blockTruePeak = jmax (blockTruePeak, std::abs (interpolated));
+                }
+            }
+
+            state.peak = jmax (blockPeak, state.peak * peakFall);
+            state.truePeak = jmax (blockPeak, blockTruePeak, state.truePeak * peakFall);
+            state.meanSquare = state.meanSquare * rmsSmoothing + (sumOfSquares / numSamples) * (1.f - rmsSmoothing);
+
+            state.levels.peak.set (state.peak);
+            state.levels.truePeak.set (state.truePeak);
+            state.levels.rms.set (std::sqrt (state.meanSquare));
+        }
+    }
+
+private:
+    enum { numTaps = 8, numPhases = 3 };
+
+    struct ChannelState
+    {
+        float peak = 0, truePeak = 0, meanSquare = 0;
+        float history[numTaps * 2] = {};
+        int historyIndex = 0;
+        Levels levels;
+    };
+
+    double sampleRate = 44100;
+    float coefficients[numPhases][numTaps];
+    ChannelState channels[numBuses][maxChannelsPerBus];
+    Atomic<int> numReaders[numBuses];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageMeterEngine)
+};
+
+#endif  // CABBAGEMETERENGINE_H_INCLUDED
@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEMIDIRING_H_INCLUDED
+#define CABBAGEMIDIRING_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// A fixed size FIFO of short MIDI messages, each stamped with the sample time it belongs
+// to. All storage is allocated up front and both ends are only ever touched from the audio
+// thread, so pushing and popping never lock or allocate. When the ring is full new events
+// are rejected and counted as drops, the events already queued are never overwritten.
+// Messages longer than three bytes, i.e. sysex and meta events, are ignored.
+//==============================================================================
+class CabbageMidiRing
+{
+public:
+    struct Event
+    {
+        int64 time;
+        uint8 data[3];
+        uint8 size;
+    };
+
+    CabbageMidiRing (int maxNumEvents = 1024)
+        : capacity (nextPowerOfTwo (maxNumEvents)),
+          events ((size_t) capacity, true)
+    {
+    }
+
+    bool push (int64 time, const uint8* data, int size) noexcept
+    {
+        if (size < 1 || size > 3)
+            return false;
+
+        if (numEvents == capacity)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        Event& e = events[(readIndex + numEvents) & (capacity - 1)];
+        e.time = time;
+        e.size = (uint8) size;
+        memcpy (e.data, data, (size_t) size);
+
+        peakDepth = jmax (peakDepth, ++numEvents);
+        return true;
+    }
+
+    bool isEmpty() const noexcept                   { return numEvents == 0; }
+
+    //the oldest event, only valid while the ring is not empty
+    const Event& front() const noexcept             { return events[readIndex]; }
+
+    void pop() noexcept
+    {
+        jassert (numEvents > 0);
+        readIndex = (readIndex + 1) & (capacity - 1);
+        --numEvents;
+    }
+
+    void clear() noexcept
+    {
+        readIndex = 0;
+        numEvents = 0;
+    }
+
+    int getCapacity() const noexcept                { return capacity; }
+    int getNumEvents() const noexcept               { return numEvents; }
+    int getPeakDepth() const noexcept               { return peakDepth; }
+    int getNumDropped() const noexcept              { return numDropped; }
+
+    void resetCounters() noexcept
+    {
+        peakDepth = numEvents;
+        numDropped = 0;
+    }
+
+private:
+    const int capacity;
+    HeapBlock<Event> events;
+    int readIndex = 0, numEvents = 0, peakDepth = 0, numDropped = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageMidiRing)
+};
+
+#endif  // CABBAGEMIDIRING_H_INCLUDED
@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageParseCache.h"
+#include "../../Widgets/CabbageWidgetData.h"
+
+static const char* const parseCacheMagic = "CBPC";
+
+CabbageParseCache::CabbageParseCache (const File& file, const CsdDocument& csd)
+    : csdFile (file)
+{
+#if ! defined(Cabbage_IDE_Build)
+    MemoryOutputStream keyData;
+    //the binary covers parser changes between Cabbage builds that leave formatVersion alone
+    const File binary (File::getSpecialLocation (File::currentExecutableFile));
+    keyData << (int) formatVersion << ProjectInfo::versionString
+            << binary.getFullPathName() << binary.getLastModificationTime().toMilliseconds() << binary.getSize()
+            << csdFile.getFullPathName() << csd.getText();
+
+    if (csd.getFormLineIndex() >= 0)
+    {
+        const String formLine = csd.getLines()[csd.getFormLineIndex()];
+
+        //import paths built from macros can't be resolved until the whole section is parsed
+        if (formLine.contains ("$"))
+            return;
+
+        ValueTree form ("temp");
+        CabbageWidgetData::setWidgetState (form, formLine, 0);
+        const var files = CabbageWidgetData::getProperty (form, CabbageIdentifierIds::importfiles);
+
+        for (int i = 0; i < files.size(); i++)
+        {
+            const File importFile = csdFile.getParentDirectory().getChildFile (files[i].toString());
+            keyData << importFile.getFullPathName();
+
+            if (importFile.existsAsFile())
+                keyData << importFile.loadFileAsString();
+        }
+    }
+
+    key = SHA256 (keyData.getData(), keyData.getDataSize()).toHexString();
+    enabled = true;
+#endif
+}
+
+File CabbageParseCache::getCacheDirectory()
+{
+    return File::getSpecialLocation (File::userApplicationDataDirectory).getChildFile ("Cabbage").getChildFile ("ParseCache");
+}
+
+File CabbageParseCache::getEntryFile (const String& extension) const
+{
+    //one entry per plugin location, rewritten whenever its key changes
+    return getCacheDirectory().getChildFile (csdFile.getFileNameWithoutExtension() + "_"
+                                             + String::toHexString (csdFile.getFullPathName().hashCode64()) + extension);
+}
+
+bool CabbageParseCache::restore (ValueTree& cabbageWidgets, File& fileToCompile) const
+{
+    if (! enabled)
+        return false;
+
+    FileInputStream input (getEntryFile (".cache"));
+
+    if (! input.openedOk())
+        return false;
+
+    char magic[4] = {};
+
+    if (input.read (magic, 4) != 4 || memcmp (magic, parseCacheMagic, 4) != 0
+        || input.readInt() != formatVersion || input.readString() != key)
+        return false;
+
+    const bool isExpanded = input.readBool();
+    const ValueTree widgets (ValueTree::readFromStream (input));
+
+    if (! widgets.isValid() || input.isExhausted() == false)
+        return false;
+
+    const File expandedCsdFile (getEntryFile (".csd"));
+
+    if (isExpanded && ! expandedCsdFile.existsAsFile())
+        return false;
+
+    cabbageWidgets.removeAllChildren (nullptr);
+
+    for (int i = 0; i < widgets.getNumChildren(); i++)
+        cabbageWidgets.addChild (widgets.getChild (i).createCopy(), -1, nullptr);
+
+    fileToCompile = isExpanded ? expandedCsdFile : csdFile;
+    return true;
+}
+
+File CabbageParseCache::store (const ValueTree& cabbageWidgets, const String& expandedCsd) const
+{
+    const File expandedCsdFile (getEntryFile (".csd"));
+
+    if (! enabled || ! getCacheDirectory().createDirectory())
+    {
+        if (expandedCsd.isEmpty())
+            return csdFile;
+
+        //nowhere to keep it, so fall back to a temporary file as before
+        const File tempFile = File::createTempFile (csdFile.getFileNameWithoutExtension() + "_temp.csd");
+        tempFile.replaceWithText (expandedCsd);
+        return tempFile;
+    }
+
+    //another instance may be compiling the current file, so swap the new one in whole,
+    //and leave it alone altogether when it hasn't changed
+    if (expandedCsd.isNotEmpty() && ! (expandedCsdFile.existsAsFile() && expandedCsdFile.loadFileAsString() == expandedCsd))
+    {
+        TemporaryFile expandedEntry (expandedCsdFile);
+
+        if (! expandedEntry.getFile().replaceWithText (expandedCsd) || ! expandedEntry.overwriteTargetFileWithTemporary())
+        {
+            //the old file is still in use, so compile from a temporary file and skip the cache entry
+            const File tempFile = File::createTempFile (csdFile.getFileNameWithoutExtension() + "_temp.csd");
+            tempFile.replaceWithText (expandedCsd);
+            return tempFile;
+        }
+    }
+
+    //write to a temporary file first so another instance never reads half an entry
+    TemporaryFile entry (getEntryFile (".cache"));
+
+    {
+        FileOutputStream output (entry.getFile());
+
+        if (! output.openedOk())
+            return expandedCsd.isEmpty() ? csdFile : expandedCsdFile;
+
+        output.write (parseCacheMagic, 4);
+        output.writeInt (formatVersion);
+        output.writeString (key);
+        output.writeBool (expandedCsd.isNotEmpty());
+        cabbageWidgets.writeToStream (output);
+    }
+
+    entry.overwriteTargetFileWithTemporary();
+    return expandedCsd.isEmpty() ? csdFile : expandedCsdFile;
+}
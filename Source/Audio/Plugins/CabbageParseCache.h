@@ -0,0 +1,61 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEPARSECACHE_H_INCLUDED
+#define CABBAGEPARSECACHE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../../Utilities/CsdDocument.h"
+
+//==============================================================================
+// Keeps the result of parsing an exported plugin's Cabbage section on disk, i.e, the widget
+// tree along with the orchestra once any imported plants have been expanded into it. Entries
+// are keyed by a SHA-256 of the .csd, its location and everything it imports, along with the
+// plugin binary that parsed them, so editing any of them or rebuilding the plugin against a
+// newer Cabbage makes the entry stale and it is rebuilt the next time the plugin loads.
+//==============================================================================
+class CabbageParseCache
+{
+public:
+    CabbageParseCache (const File& csdFile, const CsdDocument& csd);
+
+    //false when the plugin can't be cached, such as in the IDE, or when imports use macros
+    bool isEnabled() const noexcept         { return enabled; }
+
+    //fills the widget tree and sets the file Csound should compile, false if there is no valid entry
+    bool restore (ValueTree& cabbageWidgets, File& fileToCompile) const;
+
+    //expandedCsd is empty when the .csd itself can be compiled, returns the file to compile
+    File store (const ValueTree& cabbageWidgets, const String& expandedCsd) const;
+
+private:
+    static File getCacheDirectory();
+    File getEntryFile (const String& extension) const;
+
+    //bump whenever the widget tree a parse produces changes, e.g, new identifiers or defaults
+    enum { formatVersion = 2 };
+
+    File csdFile;
+    String key;
+    bool enabled = false;
+
+    JUCE_DECLARE_NON_COPYABLE (CabbageParseCache)
+};
+
+#endif  // CABBAGEPARSECACHE_H_INCLUDED
@@ -57,6 +57,7 @@ CabbagePluginEditor::CabbagePluginEditor (CabbagePluginProcessor& p)
 
 CabbagePluginEditor::~CabbagePluginEditor()
 {
+    signalAnalysisThread.stopThread (1000);
     popupPlants.clear();
     components.clear();
     radioGroups.clear();
@@ -556,16 +557,7 @@ void CabbagePluginEditor::insertLine (ValueTree cabbageWidgetData)
 //======================================================================================================
 CabbageAudioParameter* CabbagePluginEditor::getParameterForComponent (const String name)
 {
-    for (auto param : processor.getParameters())
-    {
-        if (CabbageAudioParameter* cabbageParam = dynamic_cast<CabbageAudioParameter*> (param))
-        {
-            if (name == cabbageParam->getWidgetName())
-                return dynamic_cast<CabbageAudioParameter*> (cabbageParam);
-        }
-    }
-
-    return nullptr;
+    return processor.getParameterForWidget (name);
 }
 
 //======================================================================================================
@@ -593,7 +585,7 @@ void CabbagePluginEditor::buttonClicked(Button* button)
 	if (CabbageButton* cabbageButton = dynamic_cast<CabbageButton*> (button))
 	{
 		const StringArray textItems = cabbageButton->getTextArray();
-		const ValueTree valueTree = CabbageWidgetData::getValueTreeForComponent(processor.cabbageWidgets, cabbageButton->getName());
+		const ValueTree valueTree = processor.getWidgetValueTree(cabbageButton->getName());
 		const int latched = CabbageWidgetData::getNumProp(valueTree, CabbageIdentifierIds::latched);
 
 		if (textItems.size() > 0)
@@ -607,7 +599,7 @@ void CabbagePluginEditor::buttonClicked(Button* button)
 	else if (CabbageCheckbox* cabbageButton = dynamic_cast<CabbageCheckbox*> (button))
 	{
 		const StringArray textItems = cabbageButton->getTextArray();
-		const ValueTree valueTree = CabbageWidgetData::getValueTreeForComponent(processor.cabbageWidgets, cabbageButton->getName());
+		const ValueTree valueTree = processor.getWidgetValueTree(cabbageButton->getName());
 		const int latched = CabbageWidgetData::getNumProp(valueTree, CabbageIdentifierIds::latched);
 
 		if (textItems.size() > 0)
@@ -624,7 +616,7 @@ void CabbagePluginEditor::buttonStateChanged(Button* button)
 {
 	if (CabbageButton* cabbageButton = dynamic_cast<CabbageButton*> (button))
 	{
-		const ValueTree valueTree = CabbageWidgetData::getValueTreeForComponent(processor.cabbageWidgets, cabbageButton->getName());
+		const ValueTree valueTree = processor.getWidgetValueTree(cabbageButton->getName());
 		const int latched = CabbageWidgetData::getNumProp(valueTree, CabbageIdentifierIds::latched);
 
 		if (latched == 0)
@@ -711,13 +703,36 @@ void CabbagePluginEditor::resetCurrentlySelectedComponents()
 
 Component* CabbagePluginEditor::getComponentFromName (String name)
 {
-    for (auto comp : components)
+    //components are only ever appended or cleared, so usually just the new ones need indexing
+    if (components.size() < numIndexedComponents)
     {
-        if (name == comp->getName())
-            return comp;
+        componentIndex.clear();
+        numIndexedComponents = 0;
     }
 
-    return nullptr;
+    for (; numIndexedComponents < components.size(); numIndexedComponents++)
+    {
+        Component* comp = components.getUnchecked (numIndexedComponents);
+
+        //the first of any components sharing a name is the one found
+        if (! componentIndex.contains (comp->getName()))
+            componentIndex.set (comp->getName(), comp);
+    }
+
+    if (! componentIndex.contains (name))
+        return nullptr;
+
+    Component* comp = componentIndex[name];
+
+    //deleted or renamed since it was indexed, so index everything again
+    if (comp == nullptr || comp->getName() != name)
+    {
+        componentIndex.clear();
+        numIndexedComponents = 0;
+        return getComponentFromName (name);
+    }
+
+    return comp;
 }
 
 Array<ValueTree> CabbagePluginEditor::getValueTreesForCurrentlySelectedComponents()
@@ -725,7 +740,7 @@ Array<ValueTree> CabbagePluginEditor::getValueTreesForCurrentlySelectedComponent
     Array<ValueTree> valueTreeArray;
 
     for (String compName : currentlySelectedComponentNames)
-        valueTreeArray.add (CabbageWidgetData::getValueTreeForComponent (processor.cabbageWidgets, compName));
+        valueTreeArray.add (processor.getWidgetValueTree (compName));
 
     return valueTreeArray;
 }
@@ -735,10 +750,10 @@ ValueTree CabbagePluginEditor::getValueTreeForComponent (String compName)
     if(compName == "form")//special case
     {
         resetCurrentlySelectedComponents();
-        return CabbageWidgetData::getValueTreeForComponent (processor.cabbageWidgets, "form");
+        return processor.getWidgetValueTree ("form");
     }
     else
-        return CabbageWidgetData::getValueTreeForComponent (processor.cabbageWidgets, getComponentFromName (compName)->getName());
+        return processor.getWidgetValueTree (getComponentFromName (compName)->getName());
 }
 
 void CabbagePluginEditor::updateLayoutEditorFrames()
@@ -858,6 +873,7 @@ void CabbagePluginEditor::updatefTableData (GenTable* table)
         //table->enableEditMode(fStatement);
 
         processor.getCsound()->InputMessage (fStatement.joinIntoString (" ").toUTF8());
+        processor.wakeFromIdle();
     }
 
 }
@@ -866,19 +882,25 @@ void CabbagePluginEditor::updatefTableData (GenTable* table)
 void CabbagePluginEditor::sendChannelDataToCsound (String channel, float value)
 {
     if (csdCompiledWithoutError())
-        processor.getCsound()->SetChannel (channel.getCharPointer(), value);
+        processor.queueControlChannelUpdate (processor.getControlChannelIndex (channel), value);
 }
 
 void CabbagePluginEditor::sendChannelStringDataToCsound (String channel, String value)
 {
     if (processor.csdCompiledWithoutError())
+    {
         processor.getCsound()->SetChannel (channel.getCharPointer(), value.toUTF8().getAddress());
+        processor.wakeFromIdle();
+    }
 }
 
 void CabbagePluginEditor::sendScoreEventToCsound (String scoreEvent)
 {
     if (processor.csdCompiledWithoutError())
+    {
         processor.getCsound()->InputMessage(scoreEvent.toUTF8());
+        processor.wakeFromIdle (CsdDocument::getLastEventTime (scoreEvent));
+    }
 }
 
 void CabbagePluginEditor::createEventMatrix(int cols, int rows, String channel)
@@ -894,17 +916,59 @@ void CabbagePluginEditor::setEventMatrixData(int cols, int rows, String channel,
 }
 
 
-const Array<float, CriticalSection> CabbagePluginEditor::getArrayForSignalDisplay (const String signalVariable, const String displayType)
+CabbageSignalBuffer* CabbagePluginEditor::getSignalBuffer (const String signalVariable, const String displayType)
 {
     if (csdCompiledWithoutError())
-        return processor.getSignalArray (signalVariable, displayType)->getPoints();
+        if (CsoundPluginProcessor::SignalDisplay* display = processor.getSignalArray (signalVariable, displayType))
+            return &display->buffer;
 
-    return Array<float, CriticalSection>();
+    return nullptr;
+}
+
+int CabbagePluginEditor::getNumSignalDisplays()
+{
+    return processor.getNumSignalDisplays();
+}
+
+CabbageAudioTap* CabbagePluginEditor::addAudioTap (const String source)
+{
+    return processor.addAudioTap (source);
+}
+
+void CabbagePluginEditor::removeAudioTap (CabbageAudioTap* tap)
+{
+    processor.removeAudioTap (tap);
+}
+
+CabbageMeterEngine::Levels* CabbagePluginEditor::addMeterReader (const String source)
+{
+    return processor.addMeterReader (source);
 }
 
-bool CabbagePluginEditor::shouldUpdateSignalDisplay()
+void CabbagePluginEditor::removeMeterReader (const String source)
 {
-    return processor.shouldUpdateSignalDisplay();
+    processor.removeMeterReader (source);
+}
+
+void CabbagePluginEditor::addSignalAnalyser (TimeSliceClient* analyser)
+{
+    signalAnalysisThread.addTimeSliceClient (analyser);
+
+    if (! signalAnalysisThread.isThreadRunning())
+        signalAnalysisThread.startThread (3);
+}
+
+void CabbagePluginEditor::removeSignalAnalyser (TimeSliceClient* analyser)
+{
+    signalAnalysisThread.removeTimeSliceClient (analyser);
+}
+
+double CabbagePluginEditor::getCsoundSampleRate()
+{
+    if (csdCompiledWithoutError())
+        return processor.getCsound()->GetSr();
+
+    return processor.getSampleRate() > 0 ? processor.getSampleRate() : 44100.0;
 }
 
 void CabbagePluginEditor::enableXYAutomator (String name, bool enable, Line<float> dragLine)
@@ -132,10 +132,17 @@ public:
     {
         return processor.wrapperType_AudioUnit;
     }
-    bool shouldUpdateSignalDisplay();
     void savePluginStateToFile (File snapshotFile, String presetName="");
     void restorePluginStateFrom (String childPreset);
-    const Array<float, CriticalSection> getArrayForSignalDisplay (const String signalVariable, const String displayType);
+    CabbageSignalBuffer* getSignalBuffer (const String signalVariable, const String displayType);
+    int getNumSignalDisplays();
+    double getCsoundSampleRate();
+    CabbageAudioTap* addAudioTap (const String source);
+    void removeAudioTap (CabbageAudioTap* tap);
+    CabbageMeterEngine::Levels* addMeterReader (const String source);
+    void removeMeterReader (const String source);
+    void addSignalAnalyser (TimeSliceClient* analyser);
+    void removeSignalAnalyser (TimeSliceClient* analyser);
     const String getCsoundOutputFromProcessor();
     StringArray getTableStatement (int tableNumber);
     bool csdCompiledWithoutError();
@@ -280,6 +287,8 @@ private:
     ScopedPointer<Viewport> viewport;
     ScopedPointer<ViewportContainer> viewportContainer;
     OwnedArray<Component> components;
+    HashMap<String, Component::SafePointer<Component>> componentIndex;
+    int numIndexedComponents = 0;
     Array<Component*> radioComponents;
     OwnedArray<PopupDocumentWindow> popupPlants;
     String lastOpenedDirectory;
@@ -288,6 +297,8 @@ private:
     //int xyPadIndex = 0;
     int consoleCount = 0;
     bool showScrollbars = false;
+    //runs the analysis for widgets that read audio taps, it is only started once one asks for it
+    TimeSliceThread signalAnalysisThread { "Cabbage signal analysis" };
     CabbageLookAndFeel2 lookAndFeel;
     int newlyAddedWidgetIndex = 10000;
 
@@ -19,6 +19,7 @@
 
 #include "CabbagePluginProcessor.h"
 #include "CabbagePluginEditor.h"
+#include "CabbageParseCache.h"
 
 char tmp_string[4096] = {0};
 char channelMessage[4096] = {0};
@@ -47,7 +48,7 @@ createPluginFilter() {
 	if (csdFile.existsAsFile() == false)
 		Logger::writeToLog("Could not find .csd file, please make sure it's in the correct folder");
 
-    const int numChannels = CabbageUtilities::getHeaderInfo(csdFile.loadFileAsString(), "nchnls");
+    const int numChannels = CsdDocument::forFile(csdFile)->getHeaderInfo("nchnls");
     return new CabbagePluginProcessor(csdFile, numChannels, numChannels);
 };
 
@@ -55,7 +56,8 @@ createPluginFilter() {
 CabbagePluginProcessor::CabbagePluginProcessor(File inputFile, const int ins, const int outs)
         : CsoundPluginProcessor(inputFile, ins, outs),
           csdFile(inputFile),
-          cabbageWidgets("CabbageWidgetData") 
+          cabbageWidgets("CabbageWidgetData"),
+          widgetIndex(cabbageWidgets)
 {
 	createCsound(inputFile);
 }
@@ -64,43 +66,61 @@ CabbagePluginProcessor::CabbagePluginProcessor(File inputFile, const int ins, co
 void CabbagePluginProcessor::createCsound(File inputFile, bool shouldCreateParameters)
 {
     if (inputFile.existsAsFile()) {
-        setWidthHeight();
-        StringArray linesFromCsd;
-        linesFromCsd.addLines(inputFile.loadFileAsString());
-
-        //only create extended temp file if imported plants are being added...
-        if( addImportFiles(linesFromCsd) == true )
-        {
-        parseCsdFile(linesFromCsd);
+        const CsdDocument::Ptr csd = CsdDocument::forFile(inputFile);
+        setWidthHeight(*csd);
 
+        //exported plugins reuse the widget tree and expanded orchestra from their last load
+        //unless the .csd or anything it imports has changed since
+        const CabbageParseCache parseCache(inputFile, *csd);
+        File fileToCompile(inputFile);
 
-        File tempFile = File::createTempFile(inputFile.getFileNameWithoutExtension()+"_temp.csd");
-        tempFile.replaceWithText(linesFromCsd.joinIntoString("\n")
-                                         .replace("$lt;", "<")
-                                         .replace("&amp;", "&")
-                                         .replace("$quote;", "\"")
-                                         .replace("$gt;", ">"));
-
+        if (parseCache.restore(cabbageWidgets, fileToCompile))
+        {
+            for (int i = 0; i < cabbageWidgets.getNumChildren(); i++)
+                if (CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::type) == CabbageWidgetTypes::form)
+                    applyFormSettings(cabbageWidgets.getChild(i));
+        }
+        else
+        {
+            StringArray linesFromCsd(csd->getLines());
 
+            //only create extended csd file if imported plants are being added...
+            if( addImportFiles(linesFromCsd) == true )
+            {
+                parseCsdFile(linesFromCsd);
+                fileToCompile = parseCache.store(cabbageWidgets, linesFromCsd.joinIntoString("\n")
+                                                 .replace("$lt;", "<")
+                                                 .replace("&amp;", "&")
+                                                 .replace("$quote;", "\"")
+                                                 .replace("$gt;", ">"));
+            }
+            else
+            {
+                parseCsdFile(linesFromCsd);
+                parseCache.store(cabbageWidgets, String());
+            }
+        }
 
+        //the IDE builds a new processor each time an instrument is saved and run, so it only parses
+        //here and leaves Csound to the compile thread, the instance is swapped in once it is ready
+        const bool compileInBackground = CabbageUtilities::getTarget() == CabbageUtilities::TargetTypes::IDE
+                                         && ! isNonRealtime();
 
-        if (setupAndCompileCsound(tempFile, inputFile.getParentDirectory(), samplingRate) == false)
+        if (compileInBackground)
+            compileCsoundInBackground(fileToCompile, inputFile.getParentDirectory(), true);
+        else if (setupAndCompileCsound(fileToCompile, inputFile.getParentDirectory(), samplingRate) == false)
             this->suspendProcessing(true);
-            
-        }
-        
-        else{
-            parseCsdFile(linesFromCsd);
-            if (setupAndCompileCsound(inputFile, inputFile.getParentDirectory(), samplingRate) == false)
-                this->suspendProcessing(true);
-        }
         
         if (shouldCreateParameters)
             createParameters();
 
         csoundChanList = NULL;
 
-        initAllCsoundChannels(cabbageWidgets);
+        //a background compile initialises channels from its own copy of the widget tree
+        if (!compileInBackground)
+            initAllCsoundChannels(cabbageWidgets);
+
+        updateWidgetSyncData();
 
     }
 }
@@ -116,21 +136,17 @@ CabbagePluginProcessor::~CabbagePluginProcessor() {
 }
 
 //==============================================================================
-void CabbagePluginProcessor::setWidthHeight() {
-    StringArray csdLines;
-    csdLines.addLines(csdFile.loadFileAsString());
+void CabbagePluginProcessor::setWidthHeight(const CsdDocument& csd) {
+    //only the form line needs parsing
+    if (csd.getFormLineIndex() < 0)
+        return;
 
-    for (auto line : csdLines) {
-        if(line.contains("</Cabbage>"))
-            return;
-        
-        ValueTree temp("temp");
-        CabbageWidgetData::setWidgetState(temp, line, 0);
+    ValueTree temp("temp");
+    CabbageWidgetData::setWidgetState(temp, csd.getLines()[csd.getFormLineIndex()], 0);
 
-        if (CabbageWidgetData::getStringProp(temp, CabbageIdentifierIds::type) == CabbageWidgetTypes::form) {
-            screenHeight = CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::height);
-            screenWidth = CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::width);
-        }
+    if (CabbageWidgetData::getStringProp(temp, CabbageIdentifierIds::type) == CabbageWidgetTypes::form) {
+        screenHeight = CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::height);
+        screenWidth = CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::width);
     }
 }
 
@@ -203,15 +219,8 @@ void CabbagePluginProcessor::parseCsdFile(StringArray &linesFromCsd) {
                 linesToSkip += plantStructs[i].cabbageCode.size() + 1;
         }
 
-        if (typeOfWidget == CabbageWidgetTypes::form) {
-            const String caption = CabbageWidgetData::getStringProp(tempWidget, CabbageIdentifierIds::caption);
-            setPluginName(caption.length() > 0 ? caption : "Untitled");
-
-            if (CabbageWidgetData::getNumProp(tempWidget, CabbageIdentifierIds::logger) == 1)
-                createFileLogger(this->csdFile);
-
-            setGUIRefreshRate(CabbageWidgetData::getNumProp(tempWidget, CabbageIdentifierIds::guirefresh));
-        }
+        if (typeOfWidget == CabbageWidgetTypes::form)
+            applyFormSettings(tempWidget);
 
         const String precedingCharacters = currentLineOfCabbageCode.substring(0, currentLineOfCabbageCode.indexOf(
                 typeOfWidget));
@@ -255,6 +264,17 @@ void CabbagePluginProcessor::parseCsdFile(StringArray &linesFromCsd) {
     }
 }
 
+void CabbagePluginProcessor::applyFormSettings(ValueTree form) {
+    const String caption = CabbageWidgetData::getStringProp(form, CabbageIdentifierIds::caption);
+    setPluginName(caption.length() > 0 ? caption : "Untitled");
+
+    if (CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::logger) == 1)
+        createFileLogger(this->csdFile);
+
+    setGUIRefreshRate(CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::guirefresh));
+    setIdleTime(CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::idletime));
+}
+
 bool CabbagePluginProcessor::isWidgetPlantParent(StringArray linesFromCsd, int lineNumber) {
     if (linesFromCsd[lineNumber].contains("{"))
         return true;
@@ -280,6 +300,11 @@ bool CabbagePluginProcessor::addImportFiles(StringArray &linesFromCsd) {
         ValueTree temp("temp");
         String newLine = linesFromCsd[i];
         expandMacroText(newLine, temp);
+
+        //only a form can import files, so don't bother parsing lines that can't hold one
+        if (newLine.contains("form") == false)
+            continue;
+
         CabbageWidgetData::setWidgetState(temp, newLine, 0);
 
         //if form, check for import files..
@@ -514,24 +539,16 @@ void CabbagePluginProcessor::generateCabbageCodeFromJS(PlantImportStruct &import
 void CabbagePluginProcessor::getMacros(StringArray &linesFromCsd) {
     var tempMacroNames, tempMacroStrings;
 
-    for (String csdLine : linesFromCsd) //deal with Cabbage macros
+    for (const String& csdLine : linesFromCsd) //deal with Cabbage macros
     {
-        StringArray tokens;
-        csdLine = csdLine.replace("\n", " ");
-        tokens.addTokens(csdLine, ", ");
-
-        if (tokens[0].containsIgnoreCase("define")) {
-            tokens.removeEmptyStrings();
-
-            if (tokens.size() > 1) {
-                const String currentMacroText =
-                        csdLine.substring(csdLine.indexOf(tokens[1]) + tokens[1].length()) + " ";
-                macroText.set("$" + tokens[1], " " + currentMacroText);
-                tempMacroNames.append("$" + tokens[1]);
-                tempMacroStrings.append(currentMacroText.trim());
-                macroNames = tempMacroNames;
-                macroStrings = tempMacroStrings;
-            }
+        String name, currentMacroText;
+
+        if (CsdDocument::parseMacroDefinition(csdLine, name, currentMacroText)) {
+            macroText.set("$" + name, " " + currentMacroText);
+            tempMacroNames.append("$" + name);
+            tempMacroStrings.append(currentMacroText.trim());
+            macroNames = tempMacroNames;
+            macroStrings = tempMacroStrings;
         }
     }
 
@@ -576,6 +593,7 @@ void CabbagePluginProcessor::updateWidgets(String csdText) {
     StringArray strings;
     strings.addLines(csdText);
     parseCsdFile(strings);
+    updateWidgetSyncData();
     editor->createEditorInterface(cabbageWidgets);
     editor->updateLayoutEditorFrames();
 }
@@ -604,9 +622,9 @@ void CabbagePluginProcessor::createParameters() {
                                                                        CabbageIdentifierIds::channel);
                     const float increment = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
                                                                           CabbageIdentifierIds::increment);
-                    addParameter(new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel[0],
+                    addParameter(new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel[0],
                                                            name + "_x", 0, 1, value, increment, 1));
-                    addParameter(new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel[1],
+                    addParameter(new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel[1],
                                                            name + "_y", 0, 1, value, increment, 1));
                 } else if (typeOfWidget.contains("range")) {
                     const var channel = CabbageWidgetData::getProperty(cabbageWidgets.getChild(i),
@@ -626,10 +644,10 @@ void CabbagePluginProcessor::createParameters() {
                         const float max = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
                                                                         CabbageIdentifierIds::max);
                         addParameter(
-                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel[0],
+                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel[0],
                                                           name + "_min", min, max, minValue, increment, skew));
                         addParameter(
-                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel[1],
+                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel[1],
                                                           name + "_max", min, max, maxValue, increment, skew));
                     }
                 } else if (typeOfWidget == CabbageWidgetTypes::combobox && channel.isNotEmpty()) {
@@ -638,7 +656,7 @@ void CabbagePluginProcessor::createParameters() {
                     const float max = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
                                                                     CabbageIdentifierIds::comborange);
                     addParameter(
-                            new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel, name,
+                            new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel, name,
                                                       min, max, value, 1, 1));
                 } else if (typeOfWidget.contains("slider") && channel.isNotEmpty()) {
                     const float increment = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
@@ -653,12 +671,12 @@ void CabbagePluginProcessor::createParameters() {
                             min + 1;
 
                     addParameter(
-                            new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel, name,
+                            new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel, name,
                                                       min, max, value, increment, skew));
                 } else {
                     if (channel.isNotEmpty())
                         addParameter(
-                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), *getCsound(), channel, name,
+                                new CabbageAudioParameter(this, cabbageWidgets.getChild(i), channel, name,
                                                           0, 1, value, 1, 1));
                 }
             }
@@ -795,8 +813,7 @@ void CabbagePluginProcessor::restorePluginState(XmlElement *xmlState) {
 void CabbagePluginProcessor::setParametersFromXml(XmlElement *e) {
     if (e) {
         for (int i = 1; i < e->getNumAttributes(); i++) {
-            ValueTree valueTree = CabbageWidgetData::getValueTreeForComponent(cabbageWidgets, e->getAttributeName(i),
-                                                                              true);
+            ValueTree valueTree = getWidgetValueTree(e->getAttributeName(i), true);
             const String type = CabbageWidgetData::getStringProp(valueTree, CabbageIdentifierIds::type);
 
             if (type == CabbageWidgetTypes::texteditor)
@@ -832,138 +849,165 @@ void CabbagePluginProcessor::setParametersFromXml(XmlElement *e) {
 }
 
 //==============================================================================
-void CabbagePluginProcessor::getChannelDataFromCsound() 
+// Work out once, for each widget, which channels getChannelDataFromCsound() needs to
+// watch and how. Numeric channels are resolved to control channel table indices, so
+// the periodic update only compares values and touches the ValueTree on a change.
+void CabbagePluginProcessor::updateWidgetSyncData()
 {
-	for (int i = 0; i < cabbageWidgets.getNumChildren(); i++) 
-	{
-		const var chanArray = CabbageWidgetData::getProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::channel);
-		const var widgetArray = CabbageWidgetData::getProperty(cabbageWidgets.getChild(i),
-			CabbageIdentifierIds::widgetarray);
-
-		StringArray channels;
-
-		if (widgetArray.size() > 0)
-			channels.add(CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::channel));
-		else if (chanArray.size() == 1)
-			channels.add(CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::channel));
-		else if (chanArray.size() > 1) {
-			for (int j = 0; j < chanArray.size(); j++)
-				channels.add(var(chanArray[j]));
-		}
+    widgetSyncData.clear();
 
-		const var value = CabbageWidgetData::getProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::value);
-		const float valuex = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::valuex);
-		const float valuey = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::valuey);
-		const String identChannel = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
-			CabbageIdentifierIds::identchannel);
-		const String identChannelMessage = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
-			CabbageIdentifierIds::identchannelmessage);
-		const String typeOfWidget = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
-			CabbageIdentifierIds::type);
+    for (int i = 0; i < cabbageWidgets.getNumChildren(); i++)
+    {
+        const ValueTree widget = cabbageWidgets.getChild(i);
+        WidgetSyncData::SyncType type = WidgetSyncData::noValue;
+        int first = -1, second = -1;
+        const var chanArray = CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::channel);
+        const var widgetArray = CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::widgetarray);
+        const String typeOfWidget = CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type);
+
+        if (widgetArray.size() > 0 || chanArray.size() == 1)
+        {
+            const String channel = CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::channel);
 
-		const String chann = channels[0];
+            if (channel.isNotEmpty())
+            {
+                if (CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::value).isString())
+                {
+                    type = WidgetSyncData::stringValue;
+                    widgetSyncData.stringChannels.add({ i, channel, String(), watchStringChannel(channel), -1 });
+                }
+                else if (CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::channeltype) != "string")
+                {
+                    type = WidgetSyncData::numericValue;
+                    first = getControlChannelIndex(channel);
+                }
+            }
+        }
+        //currently only dealing with a max of 2 channels...
+        else if (chanArray.size() > 1 && chanArray[0].toString().isNotEmpty() && chanArray[1].toString().isNotEmpty())
+        {
+            if (typeOfWidget == CabbageWidgetTypes::xypad)
+                type = WidgetSyncData::xyValues;
+            else if (typeOfWidget.contains("range"))
+                type = WidgetSyncData::rangeValues;
 
+            if (type != WidgetSyncData::noValue)
+            {
+                first = getControlChannelIndex(chanArray[0].toString());
+                second = getControlChannelIndex(chanArray[1].toString());
+            }
+        }
 
-		if (channels.size() == 1 && channels[0].isNotEmpty()) {
+        widgetSyncData.types.add(type);
+        widgetSyncData.firstChannels.add(first);
+        widgetSyncData.secondChannels.add(second);
+        widgetSyncData.lastFirst.add(std::numeric_limits<MYFLT>::quiet_NaN());
+        widgetSyncData.lastSecond.add(std::numeric_limits<MYFLT>::quiet_NaN());
 
-			if (value.isString() == false) 
-			{
-				if (getCsound()->GetChannel(channels[0].toUTF8()) != float(value))
-				{
-					CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::value,
-						getCsound()->GetChannel(channels[0].toUTF8()));
-				}
+        const String identChannel = CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::identchannel);
 
-			}
-			else 
+        if (identChannel.isNotEmpty())
+        {
+            WidgetSyncData::IdentSync* ident = widgetSyncData.identChannels.add(new WidgetSyncData::IdentSync());
+            ident->widget = i;
+            ident->channel = identChannel;
+            ident->watch = watchStringChannel(identChannel);
+        }
+    }
+}
+
+//==============================================================================
+void CabbagePluginProcessor::getChannelDataFromCsound() 
+{
+	//widgets may have been added by the GUI editor since the table was built
+	if (widgetSyncData.size() != cabbageWidgets.getNumChildren())
+		updateWidgetSyncData();
+
+	const uint8* const types = widgetSyncData.types.getRawDataPointer();
+	const int* const firstChannels = widgetSyncData.firstChannels.getRawDataPointer();
+	const int* const secondChannels = widgetSyncData.secondChannels.getRawDataPointer();
+	MYFLT* const lastFirst = widgetSyncData.lastFirst.getRawDataPointer();
+	MYFLT* const lastSecond = widgetSyncData.lastSecond.getRawDataPointer();
+
+	for (int i = 0; i < widgetSyncData.size(); i++)
+	{
+		if (types[i] == WidgetSyncData::numericValue)
+		{
+			const MYFLT channelValue = getControlChannel(firstChannels[i]);
+
+			if (channelValue != lastFirst[i])
 			{
-				char tmp_str[4096] = { 0 };
-				getCsound()->GetStringChannel(channels[0].toUTF8(), tmp_str);
-				CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::value,
-					String(tmp_str));
+				lastFirst[i] = channelValue;
+				CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::value, channelValue);
 			}
 		}
+		else if (types[i] == WidgetSyncData::xyValues || types[i] == WidgetSyncData::rangeValues)
+		{
+			const MYFLT firstValue = getControlChannel(firstChannels[i]);
+			const MYFLT secondValue = getControlChannel(secondChannels[i]);
 
-		//currently only dealing with a max of 2 channels...
-		else if (channels.size() == 2 && channels[0].isNotEmpty() && channels[1].isNotEmpty() &&
-			typeOfWidget != CabbageWidgetTypes::eventsequencer) {
-			if (getCsound()->GetChannel(channels[0].toUTF8()) != valuex
-				|| getCsound()->GetChannel(channels[1].toUTF8()) != valuey) {
-				if (typeOfWidget == CabbageWidgetTypes::xypad) {
-					CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::valuex,
-						getCsound()->GetChannel(channels[0].toUTF8()));
-					CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::valuey,
-						getCsound()->GetChannel(channels[1].toUTF8()));
-				}
-				else if (typeOfWidget.contains("range")) {
-					const float minValue = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
-						CabbageIdentifierIds::minvalue);
-					const float maxValue = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
-						CabbageIdentifierIds::maxvalue);
-					CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::minvalue,
-						getCsound()->GetChannel(channels[0].toUTF8()));
-					CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), CabbageIdentifierIds::maxvalue,
-						getCsound()->GetChannel(channels[1].toUTF8()));
-				}
+			if (firstValue != lastFirst[i] || secondValue != lastSecond[i])
+			{
+				lastFirst[i] = firstValue;
+				lastSecond[i] = secondValue;
+				const bool isXYPad = types[i] == WidgetSyncData::xyValues;
+				CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), isXYPad ? CabbageIdentifierIds::valuex : CabbageIdentifierIds::minvalue,
+					firstValue);
+				CabbageWidgetData::setNumProp(cabbageWidgets.getChild(i), isXYPad ? CabbageIdentifierIds::valuey : CabbageIdentifierIds::maxvalue,
+					secondValue);
 			}
 		}
+	}
 
-		if (identChannel.isNotEmpty()) {
-			memset(&tmp_string[0], 0, sizeof(tmp_string));
-			getCsound()->GetStringChannel(identChannel.toUTF8(), tmp_string);
+	//only copy out the string channels the audio thread has seen change
+	for (auto& sync : widgetSyncData.stringChannels)
+	{
+		if (!hasStringChannelChanged(sync.watch, sync.lastVersion))
+			continue;
 
-			const String identifierText(tmp_string);
-			//CabbageUtilities::debug(identifierText);
-			if (identifierText.isNotEmpty() && identifierText != identChannelMessage) {
-				CabbageWidgetData::setCustomWidgetState(cabbageWidgets.getChild(i), " " + identifierText);
+		channelMessage[0] = 0;
+		getCsound()->GetStringChannel(sync.channel.toRawUTF8(), channelMessage);
+
+		if (sync.lastValue != channelMessage)
+		{
+			sync.lastValue = channelMessage;
+			CabbageWidgetData::setProperty(cabbageWidgets.getChild(sync.widget), CabbageIdentifierIds::value, sync.lastValue);
+		}
+	}
 
-				if (identifierText.contains("tablenumber")) //update even if table number has not changed
-					CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::update, 1);
-				else if (identifierText == CabbageIdentifierIds::tofront.toString() + "()") {
-					CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::tofront,
-						Random::getSystemRandom().nextInt());
-				}
+	for (auto* ident : widgetSyncData.identChannels)
+	{
+		if (!hasStringChannelChanged(ident->watch, ident->lastVersion))
+			continue;
 
-				getCsound()->SetChannel(identChannel.toUTF8(), (char *) "");
+		tmp_string[0] = 0;
+		getCsound()->GetStringChannel(ident->channel.toRawUTF8(), tmp_string);
 
-				CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::update,
-					0); //reset value for further updates
+		//identchannels are cleared once read, so anything in there is a new message
+		if (tmp_string[0] != 0) {
+			ValueTree widget = cabbageWidgets.getChild(ident->widget);
+			const String identifierText(tmp_string);
+			ident->cache.apply(widget, identifierText);
 
+			if (identifierText.contains("tablenumber")) //update even if table number has not changed
+				CabbageWidgetData::setProperty(widget, CabbageIdentifierIds::update, 1);
+			else if (identifierText == CabbageIdentifierIds::tofront.toString() + "()") {
+				CabbageWidgetData::setProperty(widget, CabbageIdentifierIds::tofront,
+					Random::getSystemRandom().nextInt());
 			}
+
+			getCsound()->SetChannel(ident->channel.toRawUTF8(), (char *) "");
+
+			CabbageWidgetData::setProperty(widget, CabbageIdentifierIds::update,
+				0); //reset value for further updates
+
 		}
 	}
 }
 
-void CabbagePluginProcessor::triggerCsoundEvents() {
-    for (int x = 0; x < matrixEventSequencers.size(); x++) {
-        const ValueTree widgetData = CabbageWidgetData::getValueTreeForComponent(cabbageWidgets,
-                                                                                 matrixEventSequencers[x]->channel,
-                                                                                 true);
-        const String channel = CabbageWidgetData::getStringProp(widgetData, CabbageIdentifierIds::channel);
-        const int position = getCsound()->GetChannel(channel.toUTF8());
-
-        if (CabbageWidgetData::getStringProp(widgetData, CabbageIdentifierIds::orientation) == "vertical") {
-            for (int i = 0; i < CabbageWidgetData::getNumProp(widgetData, CabbageIdentifierIds::matrixcols); i++) {
-                if (matrixEventSequencers[x]->position != position) {
-                    String event = matrixEventSequencers[x]->events.getUnchecked(i)->getReference(position);
-                    if (event.isNotEmpty()) {
-                        getCsound()->InputMessage(event.toUTF8());
-                    }
-                }
-            }
-        } else //horizontal
-        {
-            for (int i = 0; i < CabbageWidgetData::getNumProp(widgetData, CabbageIdentifierIds::matrixrows); i++) {
-                if (matrixEventSequencers[x]->position != position) {
-                    String event = matrixEventSequencers[x]->events.getUnchecked(position)->getReference(i);
-                    if (event.isNotEmpty()) {
-                        getCsound()->InputMessage(event.toUTF8());
-                    }
-                }
-            }
-        }
-        matrixEventSequencers[x]->position = position;
-    }
+bool CabbagePluginProcessor::isEventMatrixVertical(const String &channel) {
+    const ValueTree widgetData = getWidgetValueTree(channel, true);
+    return CabbageWidgetData::getStringProp(widgetData, CabbageIdentifierIds::orientation) == "vertical";
 }
 
 //================================================================================
@@ -1015,27 +1059,71 @@ void CabbagePluginProcessor::enableXYAutomator(String name, bool enable, Line<fl
 
 //======================================================================================================
 CabbageAudioParameter *CabbagePluginProcessor::getParameterForXYPad(String name) {
-    for (auto param : getParameters()) {
-        if (CabbageAudioParameter *cabbageParam = dynamic_cast<CabbageAudioParameter *> (param)) {
-            if (name == cabbageParam->getWidgetName())
-                return dynamic_cast<CabbageAudioParameter *> (cabbageParam);
-        }
+    return getParameterForWidget(name);
+}
+
+CabbageAudioParameter *CabbagePluginProcessor::getParameterForWidget(const String &name) {
+    const OwnedArray<AudioProcessorParameter> &params = getParameters();
+
+    //parameters are only ever added, so the index only needs rebuilding when there are more of them
+    if (numIndexedParameters != params.size()) {
+        parameterIndices.clear();
+
+        //backwards, so that the first parameter for a widget wins as it did with a linear search
+        for (int i = params.size(); --i >= 0;)
+            if (CabbageAudioParameter *cabbageParam = dynamic_cast<CabbageAudioParameter *> (params[i]))
+                parameterIndices.set(cabbageParam->getWidgetName(), i);
+
+        numIndexedParameters = params.size();
     }
 
-    return nullptr;
+    if (!parameterIndices.contains(name))
+        return nullptr;
+
+    return static_cast<CabbageAudioParameter *> (params[parameterIndices[name]]);
 }
 
 //==============================================================================
-void CabbagePluginProcessor::setCabbageParameter(String channel, float value) {
-    getCsound()->SetChannel(channel.toUTF8().getAddress(), value);
+void CabbagePluginProcessor::setCabbageParameter(int channelIndex, float value) {
+    queueControlChannelUpdate(channelIndex, value);
 }
 
 void CabbagePluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-	
+	prepareAudioAnalysis(sampleRate);
+
     if (sampleRate != samplingRate) {
 		samplingRate = sampleRate;
-        CsoundPluginProcessor::prepareToPlay(sampleRate, samplesPerBlock);
-		createCsound(csdFile, false);
+
+        //offline renders wait for the compile, otherwise the current instance keeps the host
+        //waiting no longer than it takes to queue a background compile
+        if (isNonRealtime())
+            createCsound(csdFile, false);
+        else
+            compileCsoundInBackground(true);
+    }
+}
+
+ValueTree CabbagePluginProcessor::getChannelInitialisationData() {
+    //the compile thread mustn't touch the widget tree the editor is working on
+    return cabbageWidgets.createCopy();
+}
+
+void CabbagePluginProcessor::csoundInstanceSwapped() {
+    if (csdCompiledWithoutError() == false)
+        this->suspendProcessing(true);
+
+    updateWidgetSyncData();
+
+    //function tables belong to the instance, so have gentables read them again
+    if (csdCompiledWithoutError()) {
+        for (int i = 0; i < cabbageWidgets.getNumChildren(); i++) {
+            ValueTree widget = cabbageWidgets.getChild(i);
+
+            if (CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type) == CabbageWidgetTypes::gentable) {
+                CabbageWidgetData::setProperty(widget, CabbageIdentifierIds::update, 1);
+                CabbageWidgetData::setProperty(widget, CabbageIdentifierIds::update, 0);
+            }
+        }
     }
 }
 
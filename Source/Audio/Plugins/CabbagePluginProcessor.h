@@ -22,6 +22,8 @@
 
 #include "CsoundPluginProcessor.h"
 #include "../../Widgets/CabbageWidgetData.h"
+#include "CabbageIdentChannelCache.h"
+#include "../../Widgets/CabbageWidgetIndex.h"
 #include "../../CabbageIds.h"
 #include "../../Widgets/CabbageXYPad.h"
 
@@ -72,10 +74,11 @@ public:
 
     ValueTree cabbageWidgets;
     void getChannelDataFromCsound();
-    void triggerCsoundEvents();
-    void setWidthHeight();
+    bool isEventMatrixVertical (const String& channel) override;
+    void setWidthHeight (const CsdDocument& csd);
     bool addImportFiles (StringArray& lineFromCsd);
     void parseCsdFile (StringArray& linesFromCsd);
+    void applyFormSettings (ValueTree form);
     void createParameters();
     void updateWidgets (String csdText);
     void handleXmlImport (XmlElement* xml, StringArray& linesFromCsd);
@@ -89,8 +92,14 @@ public:
     String getPluginName() { return pluginName;  }
     void expandMacroText (String &line, ValueTree wData);
 	void prepareToPlay(double sampleRate, int samplesPerBlock);
-	void setCabbageParameter(String channel, float value);
+    ValueTree getChannelInitialisationData() override;
+    void csoundInstanceSwapped() override;
+	void setCabbageParameter(int channelIndex, float value);
+    void updateWidgetSyncData();
     CabbageAudioParameter* getParameterForXYPad (String name);
+    CabbageAudioParameter* getParameterForWidget (const String& name);
+    //looks widgets up through an index rather than walking cabbageWidgets
+    ValueTree getWidgetValueTree (const String& name, bool searchByChannel = false)  {   return widgetIndex.getWidget (name, searchByChannel);   }
     //==============================================================================
     AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -122,6 +131,61 @@ public:
 		return csdArray;
 	}
 private:
+    //what getChannelDataFromCsound() watches for the children of cabbageWidgets, along with the
+    //last values seen so that only changes reach the ValueTree. Numeric state is held in typed
+    //columns indexed by child, so the pass over every widget only reads contiguous arrays, while
+    //the few widgets with string or ident channels are kept in their own lists
+    struct WidgetSyncData
+    {
+        enum SyncType : uint8
+        {
+            noValue = 0,
+            numericValue,
+            stringValue,
+            xyValues,
+            rangeValues
+        };
+
+        struct StringSync
+        {
+            int widget;
+            String channel, lastValue;
+            int watch, lastVersion;
+        };
+
+        struct IdentSync
+        {
+            int widget;
+            String channel;
+            int watch = -1, lastVersion = -1;
+            CabbageIdentChannelCache cache;
+        };
+
+        void clear()
+        {
+            types.clearQuick();
+            firstChannels.clearQuick();
+            secondChannels.clearQuick();
+            lastFirst.clearQuick();
+            lastSecond.clearQuick();
+            stringChannels.clearQuick();
+            identChannels.clear();
+        }
+
+        int size() const noexcept       { return types.size(); }
+
+        Array<uint8> types;
+        Array<int> firstChannels, secondChannels;
+        Array<MYFLT> lastFirst, lastSecond;
+        Array<StringSync> stringChannels;
+        OwnedArray<IdentSync> identChannels;
+    };
+
+    WidgetSyncData widgetSyncData;
+    CabbageWidgetIndex widgetIndex;
+    //parameter indices by widget name, rebuilt when parameters are added
+    HashMap<String, int> parameterIndices;
+    int numIndexedParameters = 0;
     controlChannelInfo_s* csoundChanList;
     int numberOfLinesInPlantCode = 0;
     String pluginName;
@@ -142,9 +206,10 @@ class CabbageAudioParameter : public AudioParameterFloat
 {
 
 public:
-	CabbageAudioParameter(CabbagePluginProcessor* owner, ValueTree wData, Csound& csound, String channel, String name, float minValue, float maxValue, float def, float incr, float skew)
+	CabbageAudioParameter(CabbagePluginProcessor* owner, ValueTree wData, String channel, String name, float minValue, float maxValue, float def, float incr, float skew)
 		: AudioParameterFloat(name, channel, NormalisableRange<float>(minValue, maxValue, incr, skew), def), currentValue(def), widgetName(name), channel(channel), owner(owner)
 	{
+		channelIndex = owner->getControlChannelIndex(channel);
 		// widgetType = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::type);
         if(name.contains("combobox"))
             isCombo = true;
@@ -160,7 +225,7 @@ public:
 	{
 		//csound.SetChannel (channel.toUTF8(), range.convertFrom0to1 (newValue));
         currentValue = isCombo ? juce::roundToInt(range.convertFrom0to1 (newValue)) : range.convertFrom0to1 (newValue);
-		owner->setCabbageParameter(channel, currentValue);
+		owner->setCabbageParameter(channelIndex, currentValue);
 
 	}
 
@@ -169,6 +234,7 @@ public:
 	String channel;
 	String widgetName;
 	float currentValue;
+	int channelIndex = -1;
     bool isCombo = false;
 
 	CabbagePluginProcessor* owner;
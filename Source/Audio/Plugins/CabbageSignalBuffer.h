@@ -0,0 +1,106 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGESIGNALBUFFER_H_INCLUDED
+#define CABBAGESIGNALBUFFER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// A triple buffer that carries display frames from Csound's graph callbacks to the
+// signal display widgets. All three slots are allocated up front. The audio side writes
+// into the back slot and swaps it with the middle one, the GUI side swaps the middle slot
+// into the front when a fresh frame is waiting. Neither side ever locks, allocates or
+// waits on the other, and a frame the GUI doesn't get to in time is simply replaced.
+// Every frame is stamped with a sequence number so readers can tell when nothing new
+// has arrived. Any number of readers may share a buffer as long as they all run on the
+// message thread, each one keeps track of the last frame it has seen.
+//==============================================================================
+class CabbageSignalBuffer
+{
+public:
+    CabbageSignalBuffer (int maxNumPoints)
+        : capacity (jmax (1, maxNumPoints))
+    {
+        for (auto& slot : slots)
+            slot.points.allocate ((size_t) capacity, true);
+    }
+
+    //audio thread only, frames longer than the capacity are truncated
+    template <typename SampleType>
+    void publish (const SampleType* data, int numPoints) noexcept
+    {
+        Slot& slot = slots[backIndex];
+        slot.numPoints = jlimit (0, capacity, numPoints);
+
+        for (int i = 0; i < slot.numPoints; ++i)
+            slot.points[i] = (float) data[i];
+
+        slot.frame = ++numFramesPublished;
+        backIndex = middle.exchange (backIndex | freshBit) & indexMask;
+    }
+
+    //message thread only, swaps in the newest frame if there is one and returns the
+    //sequence number of the frame now at the front, 0 if nothing was published yet
+    int64 acquire() noexcept
+    {
+        if ((middle.get() & freshBit) != 0)
+            frontIndex = middle.exchange (frontIndex) & indexMask;
+
+        return slots[frontIndex].frame;
+    }
+
+    //message thread only, copies the newest frame into dest if it is newer than lastFrame
+    bool readLatest (int64& lastFrame, Array<float>& dest)
+    {
+        const int64 frame = acquire();
+
+        if (frame == 0 || frame == lastFrame)
+            return false;
+
+        const Slot& slot = slots[frontIndex];
+        dest.resize (slot.numPoints);
+        FloatVectorOperations::copy (dest.getRawDataPointer(), slot.points, slot.numPoints);
+        lastFrame = frame;
+        return true;
+    }
+
+    int getCapacity() const noexcept                { return capacity; }
+
+private:
+    struct Slot
+    {
+        HeapBlock<float> points;
+        int numPoints = 0;
+        int64 frame = 0;
+    };
+
+    enum { indexMask = 3, freshBit = 4 };
+
+    const int capacity;
+    Slot slots[3];
+    Atomic<int> middle { 1 };
+    int frontIndex = 0;             //only touched by the reader
+    int backIndex = 2;              //only touched by the writer
+    int64 numFramesPublished = 0;   //only touched by the writer
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageSignalBuffer)
+};
+
+#endif  // CABBAGESIGNALBUFFER_H_INCLUDED
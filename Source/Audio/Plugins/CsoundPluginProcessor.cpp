@@ -22,6 +22,51 @@
 #include "../../Utilities/CabbageUtilities.h"
 #include "../../Widgets/CabbageWidgetData.h"
 
+//==============================================================================
+//picks out the jobs that belong to one processor on the shared compile thread
+struct CsoundPluginProcessor::CompileJobSelector  : public ThreadPool::JobSelector
+{
+    CompileJobSelector (CsoundPluginProcessor& p) : owner (p) {}
+    bool isJobSuitable (ThreadPoolJob* job) override;
+    CsoundPluginProcessor& owner;
+};
+
+//compiles an instance on the shared compile thread and leaves it for the audio thread to swap in
+class CsoundPluginProcessor::CompileJob : public ThreadPoolJob
+{
+public:
+    CompileJob (CsoundPluginProcessor& p, File file, File path, int sr, const StringArray& names, ValueTree data)
+        : ThreadPoolJob ("Csound compile"), owner (p), csdFile (file), filePath (path),
+          sampleRate (sr), channelNames (names), channelData (data)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        ScopedPointer<CsoundInstance> instance (owner.createCsoundInstance (csdFile, filePath, sampleRate, false, channelNames));
+
+        if (instance->compileResult == 0)
+            owner.initAllCsoundChannels (channelData, instance->csound);
+
+        //a newer compile replaces one the audio thread hasn't picked up yet
+        delete owner.readyInstance.exchange (instance.release());
+        return jobHasFinished;
+    }
+
+    CsoundPluginProcessor& owner;
+
+private:
+    File csdFile, filePath;
+    int sampleRate;
+    StringArray channelNames;
+    ValueTree channelData;
+};
+
+bool CsoundPluginProcessor::CompileJobSelector::isJobSuitable (ThreadPoolJob* job)
+{
+    return &static_cast<CsoundPluginProcessor::CompileJob*> (job)->owner == &owner;
+}
+
 
 //==============================================================================
 CsoundPluginProcessor::CsoundPluginProcessor (File csdFile, const int ins, const int outs, bool debugMode)
@@ -39,11 +84,34 @@ CsoundPluginProcessor::CsoundPluginProcessor (File csdFile, const int ins, const
 
     CabbageUtilities::debug ("Plugin constructor");
 
+    hostChannelIndexes[hostBpmChannel] = getControlChannelIndex (CabbageIdentifierIds::hostbpm);
+    hostChannelIndexes[timeInSecondsChannel] = getControlChannelIndex (CabbageIdentifierIds::timeinseconds);
+    hostChannelIndexes[isPlayingChannel] = getControlChannelIndex (CabbageIdentifierIds::isplaying);
+    hostChannelIndexes[isRecordingChannel] = getControlChannelIndex (CabbageIdentifierIds::isrecording);
+    hostChannelIndexes[hostPpqPosChannel] = getControlChannelIndex (CabbageIdentifierIds::hostppqpos);
+    hostChannelIndexes[timeInSamplesChannel] = getControlChannelIndex (CabbageIdentifierIds::timeinsamples);
+    hostChannelIndexes[timeSigDenomChannel] = getControlChannelIndex (CabbageIdentifierIds::timeSigDenom);
+    hostChannelIndexes[timeSigNumChannel] = getControlChannelIndex (CabbageIdentifierIds::timeSigNum);
+
+    signalArrays.ensureStorageAllocated (maxSignalDisplays);
+    audioTaps.ensureStorageAllocated (maxAudioTaps);
+    stringChannelWatches.ensureStorageAllocated (maxStringChannelWatches);
+    audioTapChannels.allocate (maxAudioTaps, true);
+
+    for (int i = 0; i < maxAudioTaps; ++i)
+        audioTapChannels[i].generation = -1;
+
 
 }
 
 CsoundPluginProcessor::~CsoundPluginProcessor()
 {
+    //the compile thread is shared, so only wait for this processor's own jobs
+    CompileJobSelector ownJobs (*this);
+    compileThreadPool->removeAllJobs (true, -1, &ownJobs);
+    delete readyInstance.exchange (nullptr);
+    delete retiredInstance.exchange (nullptr);
+
 	resetCsound();
 }
 
@@ -68,76 +136,173 @@ void CsoundPluginProcessor::resetCsound()
 //==============================================================================
 bool CsoundPluginProcessor::setupAndCompileCsound(File csdFile, File filePath, int sr, bool debugMode)
 {
-	csound = new Csound();
 	csdFilePath = filePath;
-	csdFilePath.setAsCurrentWorkingDirectory();
-	csound->SetHostImplementedMIDIIO(true);
-	csound->SetHostImplementedAudioIO(1, 0);
-	csound->SetHostData(this);
+	compiledCsdFile = csdFile;
+	ScopedPointer<CsoundInstance> instance (createCsoundInstance(csdFile, filePath, sr, debugMode, controlChannelNames));
+
+	{
+		const ScopedLock sl (getCallbackLock());
+		installCsoundInstance(*instance);
+	}
+
+	//the instance now holds the Csound that was replaced, destroy it outside the lock
+	instance = nullptr;
+
+	addMacros(csdFile.getFullPathName());
+
+	if (csdCompiledWithoutError())
+		this->setLatencySamples(csound->GetKsmps());
+	else
+		CabbageUtilities::debug("Csound could not compile your file?");
+
+	resolveAudioTapChannels();
+	resolveStringChannelWatches();
+
+    return csdCompiledWithoutError();
+
+}
+
+//looks up the data pointer of every known control channel, channels that already exist
+//with a different type, i.e, string channels, are left unresolved
+static Array<MYFLT*> findControlChannelPointers (Csound* csound, const StringArray& channelNames)
+{
+    Array<MYFLT*> channelPtrs;
+    channelPtrs.insertMultiple (0, nullptr, channelNames.size());
+
+    for (int i = 0; i < channelNames.size() && csound != nullptr; i++)
+    {
+        MYFLT* channelPtr = nullptr;
+
+        if (csoundGetChannelPtr (csound->GetCsound(), &channelPtr, channelNames[i].toUTF8().getAddress(),
+                                 CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL) == 0)
+            channelPtrs.set (i, channelPtr);
+    }
+
+    return channelPtrs;
+}
+
+//creates and compiles a new Csound without touching anything the audio thread uses, so it
+//is safe to call from any thread
+CsoundPluginProcessor::CsoundInstance* CsoundPluginProcessor::createCsoundInstance (File csdFile, File filePath, int sr, bool debugMode, const StringArray& channelNames)
+{
+	ScopedPointer<CsoundInstance> instance (new CsoundInstance());
+	Csound* const cs = instance->csound = new Csound();
 
-	csound->CreateMessageBuffer(0);
-	csound->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
-	csound->SetExternalMidiReadCallback(ReadMidiData);
-	csound->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
-	csound->SetExternalMidiWriteCallback(WriteMidiData);
-	csoundParams = nullptr;
-	csoundParams = new CSOUND_PARAMS();
+	//this may run on the compile thread while the host and other instances are running, so rather
+	//than change the process's working directory, point Csound's own search paths at the .csd's folder
+	const String directory = filePath.getFullPathName();
 
-	csoundParams->displays = 0;
+	for (auto* searchPath : { "SSDIR", "SADIR", "INCDIR", "MFDIR" })
+		cs->SetOption((String("--env:") + searchPath + "+=" + directory).toUTF8().getAddress());
 
-	csound->SetIsGraphable(true);
-	csound->SetMakeGraphCallback(makeGraphCallback);
-	csound->SetDrawGraphCallback(drawGraphCallback);
-	csound->SetKillGraphCallback(killGraphCallback);
-	csound->SetExitGraphCallback(exitGraphCallback);
+	//sound files are written to SFDIR, or to the .csd's folder as they were when it was the working directory
+	if (SystemStats::getEnvironmentVariable("SFDIR", String()).isEmpty())
+		cs->SetOption(("--env:SFDIR=" + directory).toUTF8().getAddress());
 
+	cs->SetHostImplementedMIDIIO(true);
+	cs->SetHostImplementedAudioIO(1, 0);
+	//no host data until the instance is installed, so MIDI and graph callbacks made while it
+	//compiles can't touch the rings and displays the running instance is using
+	cs->SetHostData(nullptr);
 
-	csound->SetOption((char*)"-n");
-	csound->SetOption((char*)"-d");
-	csound->SetOption((char*)"-b0");
+	cs->CreateMessageBuffer(0);
+	cs->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
+	cs->SetExternalMidiReadCallback(ReadMidiData);
+	cs->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
+	cs->SetExternalMidiWriteCallback(WriteMidiData);
+	CSOUND_PARAMS* const params = instance->params = new CSOUND_PARAMS();
+
+	params->displays = 0;
+
+	cs->SetIsGraphable(true);
+	cs->SetMakeGraphCallback(makeGraphCallback);
+	cs->SetDrawGraphCallback(drawGraphCallback);
+	cs->SetKillGraphCallback(killGraphCallback);
+	cs->SetExitGraphCallback(exitGraphCallback);
+
+
+	cs->SetOption((char*)"-n");
+	cs->SetOption((char*)"-d");
+	cs->SetOption((char*)"-b0");
 
 
 	if (debugMode)
 	{
-		csoundDebuggerInit(csound->GetCsound());
-		csoundSetBreakpointCallback(csound->GetCsound(), breakpointCallback, (void*)this);
-		csoundSetInstrumentBreakpoint(csound->GetCsound(), 1, 413);
-		csoundParams->ksmps_override = 4410;
+		csoundDebuggerInit(cs->GetCsound());
+		csoundSetBreakpointCallback(cs->GetCsound(), breakpointCallback, (void*)this);
+		csoundSetInstrumentBreakpoint(cs->GetCsound(), 1, 413);
+		params->ksmps_override = 4410;
 	}
 
+	const CsdDocument::Ptr csd = CsdDocument::forFile(csdFile);
+
 	//instrument must at least be stereo
-	numCsoundChannels = CabbageUtilities::getHeaderInfo(csdFile.loadFileAsString(), "nchnls");
-	const int requestedSampleRate = CabbageUtilities::getHeaderInfo(csdFile.loadFileAsString(), "sr");
-	const int requestedKsmpsRate = CabbageUtilities::getHeaderInfo(csdFile.loadFileAsString(), "ksmps");
-	csoundParams->nchnls_override = numCsoundChannels;
+	instance->numChannels = csd->getHeaderInfo("nchnls");
+	//an encrypted score can't be read, so idle mode treats it as never finished
+	instance->lastScoreEventTime = csd->hasCsoundSection() ? csd->getLastScoreEventTime() : std::numeric_limits<double>::max();
+	const int requestedSampleRate = csd->getHeaderInfo("sr");
+	const int requestedKsmpsRate = csd->getHeaderInfo("ksmps");
+	params->nchnls_override = instance->numChannels;
 	//only override sample rate if user insists
 #if !defined(Cabbage_IDE_Build)
 	PluginHostType pluginType;
 	if (pluginType.isFruityLoops())
 	{
         //fruity loops has issues with certain ksmps sizes. Best that users set their own ksmps values
-		//csoundParams->ksmps_override = 1;
+		//params->ksmps_override = 1;
 	}
 #else
 	if (requestedKsmpsRate == -1)
-		csoundParams->ksmps_override = 32;
+		params->ksmps_override = 32;
 #endif
-	csoundParams->sample_rate_override = requestedSampleRate>0 ? requestedSampleRate : sr;
+	if (ksmpsOverride > 0)
+		params->ksmps_override = ksmpsOverride;
+	params->sample_rate_override = requestedSampleRate>0 ? requestedSampleRate : sr;
+
+	cs->SetParams(params);
 
-	csound->SetParams(csoundParams);
+#ifdef Cabbage_Benchmark
+	const int64 compileStartTicks = Time::getHighResolutionTicks();
+#endif
 
-	if (csdFile.loadFileAsString().contains("<Csound") || csdFile.loadFileAsString().contains("</Csound"))
-		compileCsdFile(csdFile);
+	if (csd->hasCsoundSection())
+		instance->compileResult = cs->Compile (const_cast<char*> (csdFile.getFullPathName().toUTF8().getAddress()));
 	else
 	{
 #ifdef CabbagePro
-		compileCsdString(Encrypt::decode(csdFile));
-		csound->Start();
+		instance->compileResult = cs->CompileCsdText (const_cast<char*> (Encrypt::decode(csdFile).toUTF8().getAddress()));
+		cs->Start();
 #endif
 }
 
-	addMacros(csdFile.getFullPathName());
+#ifdef Cabbage_Benchmark
+	performanceCounters.lastCompileTicks = Time::getHighResolutionTicks() - compileStartTicks;
+	performanceCounters.numCompiles++;
+#endif
+
+	if (instance->compileResult == 0)
+		instance->channelPointers = findControlChannelPointers(cs, channelNames);
+
+	return instance.release();
+}
 
+//swaps the instance's Csound, and the state derived from it, with the processor's own, call
+//this from the audio thread or with the callback lock held
+void CsoundPluginProcessor::installCsoundInstance (CsoundInstance& instance)
+{
+	csound.swapWith(instance.csound);
+	csoundParams.swapWith(instance.params);
+	std::swap(csCompileResult, instance.compileResult);
+	std::swap(numCsoundChannels, instance.numChannels);
+	std::swap(lastScoreEventTime, instance.lastScoreEventTime);
+	controlChannelPointers.swapWith(instance.channelPointers);
+	++csoundGeneration;
+
+	if (csound != nullptr)
+		csound->SetHostData(this);
+
+	if (instance.csound != nullptr)
+		instance.csound->SetHostData(nullptr);
 
 	if (csdCompiledWithoutError())
 	{
@@ -145,15 +310,48 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File csdFile, File filePath, i
 		CSspout = csound->GetSpout();
 		CSspin = csound->GetSpin();
 		cs_scale = csound->Get0dBFS();
+		cs_scaleInverse = 1.0 / cs_scale;
 		csndIndex = csound->GetKsmps();
-
-		this->setLatencySamples(csound->GetKsmps());
+		midiInputRing.clear();
+		midiOutputRing.clear();
+		silentSamples = 0;
+		sentEventsEndTime = 0.0;
+		idleSkippedSamples = 0;
+		idlePerformedSamples = 0;
 	}
-	else
-		CabbageUtilities::debug("Csound could not compile your file?");
+}
 
-    return csdCompiledWithoutError();
+void CsoundPluginProcessor::compileCsoundInBackground (File csdFile, File filePath, bool muteUntilReady)
+{
+    csdFilePath = filePath;
+    compiledCsdFile = csdFile;
+    compileCsoundInBackground (muteUntilReady);
+}
 
+void CsoundPluginProcessor::compileCsoundInBackground (bool muteUntilReady)
+{
+    if (compiledCsdFile.existsAsFile() == false)
+        return;
+
+    if (muteUntilReady)
+        muteUntilSwap = 1;
+
+    //anything still queued for this processor would only be replaced by this compile
+    CompileJobSelector ownJobs (*this);
+    compileThreadPool->removeAllJobs (false, 0, &ownJobs);
+
+    compileThreadPool->addJob (new CompileJob (*this, compiledCsdFile, csdFilePath, samplingRate,
+                                               controlChannelNames, getChannelInitialisationData()), true);
+}
+
+//audio thread only, the replaced instance is handed to the message thread to be destroyed
+void CsoundPluginProcessor::swapInReadyInstance()
+{
+    CsoundInstance* const instance = readyInstance.exchange (nullptr);
+    installCsoundInstance (*instance);
+    retiredInstance = instance;
+    muteUntilSwap = 0;
+    triggerAsyncUpdate();
 }
 
 
@@ -164,8 +362,12 @@ void CsoundPluginProcessor::createFileLogger (File csdFile)
     Logger::setCurrentLogger (fileLogger);
 }
 //==============================================================================
-void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData)
+void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData, Csound* target)
 {
+    //an instance passed in is being built on the compile thread and isn't installed yet
+    const bool isStagedInstance = target != nullptr;
+    Csound* const csound = isStagedInstance ? target : this->csound.get();
+
     for (int i = 0; i < cabbageData.getNumChildren(); i++)
     {
         const String typeOfWidget = CabbageWidgetData::getStringProp (cabbageData.getChild (i), CabbageIdentifierIds::type);
@@ -233,7 +435,10 @@ void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData)
 
     csound->SetStringChannel ("LAST_FILE_DROPPED", "");
 
-    csdFilePath.setAsCurrentWorkingDirectory();
+    //the compile thread leaves the working directory alone, a staged instance finds the .csd's
+    //folder through the search paths set in createCsoundInstance()
+    if (! isStagedInstance)
+        csdFilePath.setAsCurrentWorkingDirectory();
 
 	if(SystemStats::getOperatingSystemType() == SystemStats::OperatingSystemType::Linux)
     {
@@ -294,7 +499,9 @@ void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData)
     {
         csound->SetChannel ("IS_A_PLUGIN", 1.0);
 
-        if (getPlayHead() != 0 && getPlayHead()->getCurrentPosition (hostInfo))
+        //the play head can only be read from processBlock, which sets the transport channels
+        //of a staged instance in its first block after the swap
+        if (! isStagedInstance && getPlayHead() != 0 && getPlayHead()->getCurrentPosition (hostInfo))
         {
             csound->SetChannel (CabbageIdentifierIds::hostbpm.toUTF8(), hostInfo.bpm);
             csound->SetChannel (CabbageIdentifierIds::timeinseconds.toUTF8(), hostInfo.timeInSeconds);
@@ -309,10 +516,207 @@ void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData)
     else
         csound->SetChannel ("IS_A_PLUGIN", 0.0);
 
-    csound->PerformKsmps();
+    //a staged instance runs its first k-cycle on the audio thread once it is installed
+    if (! isStagedInstance)
+        csound->PerformKsmps();
+
+
+}
+//==============================================================================
+int CsoundPluginProcessor::getControlChannelIndex (const String& channelName)
+{
+    if (controlChannelIndexes.contains (channelName))
+        return controlChannelIndexes[channelName];
+
+    const int index = controlChannelNames.size();
+    controlChannelNames.add (channelName);
+    controlChannelIndexes.set (channelName, index);
+    channelUpdateQueue.ensureCapacity (controlChannelNames.size());
+
+    MYFLT* channelPtr = nullptr;
+
+    if (csound != nullptr && csdCompiledWithoutError())
+    {
+        if (csoundGetChannelPtr (csound->GetCsound(), &channelPtr, channelName.toUTF8().getAddress(),
+                                 CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL) != 0)
+            channelPtr = nullptr;
+    }
+
+    const ScopedLock sl (getCallbackLock());
+    controlChannelPointers.add (channelPtr);
+    return index;
+}
+
+void CsoundPluginProcessor::resolveControlChannelPointers()
+{
+    Array<MYFLT*> channelPtrs (findControlChannelPointers (csdCompiledWithoutError() ? csound.get() : nullptr,
+                                                           controlChannelNames));
+    channelUpdateQueue.ensureCapacity (controlChannelNames.size());
+
+    //swap in the new table in one go so the audio thread never sees a half built one
+    const ScopedLock sl (getCallbackLock());
+    controlChannelPointers.swapWith (channelPtrs);
+}
+
+//control channel data is a single aligned MYFLT, so it is written and read in place rather
+//than through csoundSetControlChannel() and its per call name lookup
+void CsoundPluginProcessor::setControlChannel (int index, MYFLT value)
+{
+    if (MYFLT* channelPtr = controlChannelPointers[index])
+        *channelPtr = value;
+}
+
+void CsoundPluginProcessor::queueControlChannelUpdate (int index, MYFLT value)
+{
+    //the queue grows with the channel table, so a rejected index is one that was never handed
+    //out. It is counted as a drop rather than written from this thread
+    channelUpdateQueue.push (index, value);
+}
+
+MYFLT CsoundPluginProcessor::getControlChannel (int index) const
+{
+    if (MYFLT* channelPtr = controlChannelPointers[index])
+        return *channelPtr;
+
+    return 0;
+}
+
+//==============================================================================
+static uint64 hashString (const char* text)
+{
+    uint64 hash = 14695981039346656037ULL;
+
+    for (; *text != 0; ++text)
+        hash = (hash ^ (uint8) *text) * 1099511628211ULL;
+
+    return hash;
+}
+
+//copies the channel's text with Csound's own locking, false if it won't fit in the watch's buffer
+static bool readStringChannel (CSOUND* cs, const char* name, HeapBlock<char>& buffer, int bufferSize)
+{
+    if (csoundGetChannelDatasize (cs, name) >= bufferSize)
+        return false;
+
+    buffer[0] = 0;
+    csoundGetStringChannel (cs, name, buffer);
+    return true;
+}
+
+int CsoundPluginProcessor::watchStringChannel (const String& channelName)
+{
+    if (stringChannelWatchIndexes.contains (channelName))
+        return stringChannelWatchIndexes[channelName];
+
+    const int index = numStringChannelWatches.get();
+
+    if (index == maxStringChannelWatches)
+        return -1;
+
+    //the storage was reserved up front, so adding never moves what the audio thread reads
+    StringChannelWatch* const watch = stringChannelWatches.add (new StringChannelWatch());
+    watch->name = channelName;
+    stringChannelWatchIndexes.set (channelName, index);
+    numStringChannelWatches.set (index + 1);
+    resolveStringChannelWatches();
+    return index;
+}
+
+bool CsoundPluginProcessor::hasStringChannelChanged (int index, int& lastVersion) const
+{
+    if (! isPositiveAndBelow (index, numStringChannelWatches.get()))
+        return true;
+
+    const int version = stringChannelWatches.getUnchecked (index)->version.get();
+
+    if (version == lastVersion)
+        return false;
+
+    lastVersion = version;
+    return true;
+}
+
+void CsoundPluginProcessor::resolveStringChannelWatches()
+{
+    const int generation = csoundGeneration.get();
+
+    for (int i = 0; i < numStringChannelWatches.get(); ++i)
+    {
+        StringChannelWatch* const watch = stringChannelWatches.getUnchecked (i);
+
+        if (watch->generation == generation)
+            continue;
+
+        bool exists = false;
+        int bufferSize = 0;
+        HeapBlock<char> buffer;
+        uint64 hash = 0;
+
+        if (csound != nullptr && csdCompiledWithoutError())
+        {
+            CSOUND* const cs = csound->GetCsound();
+            const char* const name = watch->name.toRawUTF8();
+            MYFLT* channelPtr = nullptr;
+
+            if (csoundGetChannelPtr (cs, &channelPtr, name,
+                                     CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL) == 0)
+            {
+                //leave room for the text to grow before the audio thread has to give up on hashing it
+                exists = true;
+                bufferSize = jmax (1024, csoundGetChannelDatasize (cs, name) * 2);
+                buffer.malloc ((size_t) bufferSize);
+
+                if (readStringChannel (cs, name, buffer, bufferSize))
+                    hash = hashString (buffer);
+            }
+        }
+
+        //if another instance went in while we were looking, the next swap resolves it again
+        const ScopedLock sl (getCallbackLock());
+
+        if (csoundGeneration.get() == generation)
+        {
+            watch->exists = exists;
+            watch->text.swapWith (buffer);
+            watch->textSize = bufferSize;
+            watch->lastHash = hash;
+            watch->generation = generation;
+            //a new instance may hold different text, so have the GUI read it once
+            ++watch->version;
+        }
+    }
+}
+
+//audio thread, hashing is cheap next to copying every channel out on the message thread
+void CsoundPluginProcessor::checkStringChannelWatches()
+{
+    CSOUND* const cs = csound->GetCsound();
+    const int generation = csoundGeneration.get();
+
+    for (int i = numStringChannelWatches.get(); --i >= 0;)
+    {
+        StringChannelWatch* const watch = stringChannelWatches.getUnchecked (i);
+
+        if (! watch->exists || watch->generation != generation)
+            continue;
+
+        //text that outgrew the buffer can't be compared here, so the GUI reads it every time
+        if (! readStringChannel (cs, watch->name.toRawUTF8(), watch->text, watch->textSize))
+        {
+            ++watch->version;
+            continue;
+        }
 
+        const uint64 hash = hashString (watch->text);
 
+        if (hash != watch->lastHash)
+        {
+            watch->lastHash = hash;
+            ++watch->version;
+        }
+    }
 }
+
 //==============================================================================
 void CsoundPluginProcessor::addMacros (String csdText)
 {
@@ -349,11 +753,11 @@ void CsoundPluginProcessor::addMacros (String csdText)
 }
 
 //==============================================================================
-void CsoundPluginProcessor::createMatrixEventSequencer(int rows, int cols, String channel)
+void CsoundPluginProcessor::createMatrixEventSequencer(int cols, int rows, String channel)
 {
     MatrixEventSequencer* matrix = new MatrixEventSequencer(channel);
-    (channel);
 
+    //cells are stored as events[col][row]
     for (int i = 0 ; i < cols ; i++)
     {
         matrix->events.add (new StringArray());
@@ -365,17 +769,56 @@ void CsoundPluginProcessor::createMatrixEventSequencer(int rows, int cols, Strin
     }
 
     matrixEventSequencers.add(matrix);
+    eventMatrixChanged = true;
+    triggerAsyncUpdate();
 }
 
 void CsoundPluginProcessor::setMatrixEventSequencerCellData(int col, int row, String channel, String data)
 {
     for (int i = 0 ; i < matrixEventSequencers.size(); i++)
     {
-        if (matrixEventSequencers[i]->channel == channel)
+        if (matrixEventSequencers[i]->channel == channel && matrixEventSequencers[i]->events[col] != nullptr)
         {
             matrixEventSequencers[i]->setEventString(col, row, data);
         }
     }
+
+    //cells tend to be set in bulk, so the recompile waits for the next message loop
+    eventMatrixChanged = true;
+    triggerAsyncUpdate();
+}
+
+void CsoundPluginProcessor::compileEventMatrix()
+{
+    ScopedPointer<CabbageEventMatrix> newMatrix (new CabbageEventMatrix());
+
+    for (auto* sequencer : matrixEventSequencers)
+    {
+        const int numCols = sequencer->events.size();
+        const int numRows = numCols > 0 ? sequencer->events[0]->size() : 0;
+        const bool isVertical = isEventMatrixVertical (sequencer->channel);
+
+        newMatrix->addSequencer (getControlChannelIndex (sequencer->channel));
+
+        for (int step = 0; step < (isVertical ? numRows : numCols); step++)
+        {
+            for (int i = 0; i < (isVertical ? numCols : numRows); i++)
+                newMatrix->addEvent (isVertical ? (*sequencer->events[i])[step] : (*sequencer->events[step])[i]);
+
+            newMatrix->endStep();
+        }
+    }
+
+    {
+        const SpinLock::ScopedLockType sl (eventMatrixLock);
+
+        if (eventMatrix != nullptr)
+            newMatrix->carryPositionsFrom (*eventMatrix);
+
+        eventMatrix.swapWith (newMatrix);
+    }
+
+    //the previous matrix is freed here, away from the audio thread
 }
 
 //==============================================================================
@@ -524,15 +967,27 @@ void CsoundPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBloc
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
+    prepareAudioAnalysis (sampleRate);
+
     if(samplingRate != sampleRate)
     {
-        //if sampling rate is other than default or has been changed, recompile..
+        //if sampling rate is other than default or has been changed, recompile. Offline renders
+        //can't afford to drop any output so they still wait for the compile
         samplingRate = sampleRate;
-        setupAndCompileCsound(csdFile, csdFilePath);
+
+        if (isNonRealtime())
+            setupAndCompileCsound(csdFile, csdFilePath, samplingRate);
+        else
+            compileCsoundInBackground(true);
     }
     
 }
 
+void CsoundPluginProcessor::prepareAudioAnalysis (double sampleRate)
+{
+    meterEngine.prepare (sampleRate);
+}
+
 void CsoundPluginProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
@@ -584,11 +1039,43 @@ bool CsoundPluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 //==========================================================================
 void CsoundPluginProcessor::triggerCsoundEvents()
 {
+    //never wait for the message thread, if a new matrix is being swapped in any
+    //step change is picked up on the next k-cycle instead
+    const GenericScopedTryLock<SpinLock> sl (eventMatrixLock);
+
+    if (! sl.isLocked() || eventMatrix == nullptr)
+        return;
+
+    const double startDelay = eventMatrix->triggerChangedSteps ([this] (int channelIndex) { return (int) getControlChannel (channelIndex); },
+                                                                [this] (char type, const MYFLT* pFields, long numPFields) { csound->ScoreEvent (type, pFields, numPFields); },
+                                                                [this] (const char* scoreText) { csound->InputMessage (scoreText); });
 
+    if (idleTime > 0.0 && startDelay > 0.0)
+        holdAwakeForEvents (startDelay);
 }
 
 void CsoundPluginProcessor::handleAsyncUpdate()
 {
+    if (CsoundInstance* const retired = retiredInstance.exchange (nullptr))
+    {
+        delete retired;
+        //pick up any channels that were registered while the compile was running
+        resolveControlChannelPointers();
+        resolveAudioTapChannels();
+        resolveStringChannelWatches();
+
+        if (csdCompiledWithoutError())
+            setLatencySamples (csdKsmps);
+
+        csoundInstanceSwapped();
+    }
+
+    if (eventMatrixChanged)
+    {
+        eventMatrixChanged = false;
+        compileEventMatrix();
+    }
+
     getChannelDataFromCsound();
     sendChannelDataToCsound();
 }
@@ -603,26 +1090,43 @@ void CsoundPluginProcessor::sendHostDataToCsound()
             
             if (ph->getCurrentPosition (hostInfo))
             {
-                csound->SetChannel (CabbageIdentifierIds::hostbpm.toUTF8(), hostInfo.bpm);
-                csound->SetChannel (CabbageIdentifierIds::timeinseconds.toUTF8(), hostInfo.timeInSeconds);
-                csound->SetChannel (CabbageIdentifierIds::isplaying.toUTF8(), hostInfo.isPlaying);
-                csound->SetChannel (CabbageIdentifierIds::isrecording.toUTF8(), hostInfo.isRecording);
-                csound->SetChannel (CabbageIdentifierIds::hostppqpos.toUTF8(), hostInfo.ppqPosition);
-                csound->SetChannel (CabbageIdentifierIds::timeinsamples.toUTF8(), hostInfo.timeInSamples);
-                csound->SetChannel (CabbageIdentifierIds::timeSigDenom.toUTF8(), hostInfo.timeSigDenominator);
-                csound->SetChannel (CabbageIdentifierIds::timeSigNum.toUTF8(), hostInfo.timeSigNumerator);
+                setControlChannel (hostChannelIndexes[hostBpmChannel], hostInfo.bpm);
+                setControlChannel (hostChannelIndexes[timeInSecondsChannel], hostInfo.timeInSeconds);
+                setControlChannel (hostChannelIndexes[isPlayingChannel], hostInfo.isPlaying);
+                setControlChannel (hostChannelIndexes[isRecordingChannel], hostInfo.isRecording);
+                setControlChannel (hostChannelIndexes[hostPpqPosChannel], hostInfo.ppqPosition);
+                setControlChannel (hostChannelIndexes[timeInSamplesChannel], hostInfo.timeInSamples);
+                setControlChannel (hostChannelIndexes[timeSigDenomChannel], hostInfo.timeSigDenominator);
+                setControlChannel (hostChannelIndexes[timeSigNumChannel], hostInfo.timeSigNumerator);
             }
         }
     }
 }
+//==============================================================================
+// Block based audio IO. Csound's spin/spout buffers are interleaved MYFLT frames, so
+// each host channel is written/read with a fixed stride over a whole ksmps chunk at a
+// time. These loops carry no branches and are simple enough for the compiler to vectorise.
+//==============================================================================
+static void copyToCsoundInterleaved (MYFLT* spin, const float* source, int numSamples, int channel, int numChannels, MYFLT scale)
+{
+    MYFLT* dest = spin + channel;
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i * numChannels] = source[i] * scale;
+}
+
+static void copyFromCsoundInterleaved (float* dest, const MYFLT* spout, int numSamples, int channel, int numChannels, MYFLT inverseScale)
+{
+    const MYFLT* source = spout + channel;
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = float (source[i * numChannels] * inverseScale);
+}
+
 void CsoundPluginProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
     float** audioBuffers = buffer.getArrayOfWritePointers();
     const int numSamples = buffer.getNumSamples();
-    
-    MYFLT newSamp;
-    int result = -1;
-
 
 	const int output_channel_count = (numCsoundChannels > getTotalNumOutputChannels() ? getTotalNumOutputChannels() : numCsoundChannels);
 
@@ -630,66 +1134,127 @@ void CsoundPluginProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
     if (getTotalNumInputChannels() == 0)
         buffer.clear();
 
+    const bool tapsAreRead = numAudioTapReaders.get() > 0;
+
+    if (tapsAreRead)
+        pushBusTaps (CabbageAudioTap::inputBus, buffer, getTotalNumInputChannels());
+
+    if (meterEngine.isActive (CabbageMeterEngine::inputBus))
+        meterEngine.process (CabbageMeterEngine::inputBus, buffer, getTotalNumInputChannels());
+
 	keyboardState.processNextMidiBuffer(midiMessages, 0, numSamples, true);
-	midiBuffer.addEvents(midiMessages, 0, numSamples, 0);
-    
 
+    //a background compile has finished, fade the current instance out over this block and swap
+    //the new one in at the start of the next, or straight away if nothing can be heard anyway
+    bool fadeOutThisBlock = false, fadeInThisBlock = false;
+
+    if (readyInstance.get() != nullptr && retiredInstance.get() == nullptr)
+    {
+        if (fadeOutBeforeSwap || muteUntilSwap.get() != 0 || ! csdCompiledWithoutError())
+        {
+            swapInReadyInstance();
+            fadeOutBeforeSwap = false;
+            fadeInThisBlock = true;
+        }
+        else
+            fadeOutBeforeSwap = fadeOutThisBlock = true;
+    }
+
+    if (muteUntilSwap.get() != 0)
+    {
+        buffer.clear();
+        midiMessages.clear();
+        return;
+    }
 
     if (csdCompiledWithoutError())
     {
+        if (idleTime > 0.0 && isIdleBlock (buffer, midiMessages))
+        {
+            buffer.clear();
+            midiMessages.clear();
+            midiBlockStart += numSamples;
+            idleSkippedSamples += numSamples;
+
+            if (tapsAreRead)
+                pushBusTaps (CabbageAudioTap::outputBus, buffer, output_channel_count);
+
+            if (meterEngine.isActive (CabbageMeterEngine::outputBus))
+                meterEngine.process (CabbageMeterEngine::outputBus, buffer, output_channel_count);
+
+            return;
+        }
+
+        //queue this block's MIDI with its sample offsets so each k-cycle only sees its own events
+        MidiBuffer::Iterator midiIterator (midiMessages);
+        const uint8* midiData;
+        int midiDataSize, midiSamplePos;
+
+        //if Csound falls this far behind the oldest events are kept and the newest are
+        //dropped, see getMidiInputRing().getNumDropped()
+        while (midiIterator.getNextEvent (midiData, midiDataSize, midiSamplePos))
+            midiInputRing.push (midiBlockStart + midiSamplePos, midiData, midiDataSize);
+
         //mute unused channels
         for (int channelsToClear = output_channel_count; channelsToClear < getTotalNumOutputChannels(); ++channelsToClear)
         {
             buffer.clear (channelsToClear, 0, buffer.getNumSamples());
         }
 
-        for (int i = 0; i < numSamples; i++, ++csndIndex)
+        //fast path - when the host block is a whole number of k-cycles and we are sitting on a
+        //k-boundary every chunk below is exactly ksmps long, otherwise the first and last chunks
+        //are partial and carry over into the next call via csndIndex
+        int samplePos = 0;
+
+        while (samplePos < numSamples)
         {
             if (csndIndex == csdKsmps)
             {
-                    result = csound->PerformKsmps();
+                midiSliceEnd = midiBlockStart + samplePos + csdKsmps;
+                midiOutputOffset = samplePos;
 
-                if (result == 0)
-                {
-                    //slow down calls to these functions, no need for them to be firing at k-rate
-                    if (guiCycles > guiRefreshRate)
-                    {
-                        guiCycles = 0;
-                        triggerAsyncUpdate();
-                    }
-                    else
-                        ++guiCycles;
-
-                    //trigger any Csound score event on each k-boundary
-                    triggerCsoundEvents();
-                    sendHostDataToCsound();
-
-                    disableLogging = false;
-                }
-                else
-                {
-                    disableLogging = true;
+                if (performKsmps() == false)
                     return; //return as soon as Csound has stopped
-                }
 
                 csndIndex = 0;
-
             }
 
-            pos = csndIndex * output_channel_count;
+            const int samplesThisChunk = jmin (numSamples - samplePos, csdKsmps - csndIndex);
+            const int frameOffset = csndIndex * output_channel_count;
 
             for (int channel = 0; channel < output_channel_count; ++channel)
             {
-                float*& current_sample = audioBuffers[channel];
-                newSamp = *current_sample * cs_scale;
-                CSspin[pos] = newSamp;
-                *current_sample = (CSspout[pos] / cs_scale);
-                ++current_sample;
-                ++pos;
-
+                float* const channelData = audioBuffers[channel] + samplePos;
+                copyToCsoundInterleaved (CSspin + frameOffset, channelData, samplesThisChunk, channel, output_channel_count, cs_scale);
+                copyFromCsoundInterleaved (channelData, CSspout + frameOffset, samplesThisChunk, channel, output_channel_count, cs_scaleInverse);
             }
+
+            csndIndex += samplesThisChunk;
+            samplePos += samplesThisChunk;
+        }
+
+        midiBlockStart += numSamples;
+
+        if (idleTime > 0.0)
+        {
+            lastOutputPeak = 0.f;
+
+            for (int channel = 0; channel < output_channel_count; ++channel)
+                lastOutputPeak = jmax (lastOutputPeak, buffer.getMagnitude (channel, 0, numSamples));
+
+            idlePerformedSamples += numSamples;
         }
 
+        if (fadeOutThisBlock)
+            buffer.applyGainRamp (0, numSamples, 1.f, 0.f);
+        else if (fadeInThisBlock)
+            buffer.applyGainRamp (0, numSamples, 0.f, 1.f);
+
+        if (tapsAreRead)
+            pushBusTaps (CabbageAudioTap::outputBus, buffer, output_channel_count);
+
+        if (meterEngine.isActive (CabbageMeterEngine::outputBus))
+            meterEngine.process (CabbageMeterEngine::outputBus, buffer, output_channel_count);
 
     }//if not compiled just mute output
     else
@@ -702,17 +1267,104 @@ void CsoundPluginProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
 
 #if JucePlugin_ProducesMidiOutput
 
-    if (!midiOutputBuffer.isEmpty())
+    midiMessages.clear();
+
+    while (! midiOutputRing.isEmpty())
     {
-        midiMessages.clear();
-        midiMessages.swapWith (midiOutputBuffer);
+        const CabbageMidiRing::Event& event = midiOutputRing.front();
+        midiMessages.addEvent (event.data, event.size, (int) event.time);
+        midiOutputRing.pop();
     }
-    else
-        midiMessages.clear();
 
+#else
+    midiOutputRing.clear();
 #endif
 }
 
+bool CsoundPluginProcessor::isIdleBlock (const AudioSampleBuffer& buffer, const MidiBuffer& midiMessages)
+{
+    //roughly -100dB, low enough to let reverb and delay tails ring out
+    const float silenceThreshold = 1.0e-5f;
+    const bool wakeRequested = idleWakeRequested.exchange (0) != 0;
+
+    if (wakeRequested)
+        holdAwakeForEvents (idleWakeStartDelay.exchange (0.0));
+
+    bool isActive = wakeRequested
+                    || lastOutputPeak > silenceThreshold
+                    || ! midiMessages.isEmpty()
+                    || ! midiInputRing.isEmpty()
+                    || channelUpdateQueue.getNumPending() > 0
+                    || hasPendingCsoundEvents();
+
+    for (int channel = 0; channel < getTotalNumInputChannels() && ! isActive; ++channel)
+        isActive = buffer.getMagnitude (channel, 0, buffer.getNumSamples()) > silenceThreshold;
+
+    if (isActive)
+    {
+        silentSamples = 0;
+        return false;
+    }
+
+    silentSamples += buffer.getNumSamples();
+    return silentSamples >= int64 (idleTime * samplingRate);
+}
+
+//score time stands still while Csound sleeps, so anything still to start would never fire.
+//Events scheduled from inside the orchestra, with event or schedule, aren't seen here
+bool CsoundPluginProcessor::hasPendingCsoundEvents() const
+{
+    const double scoreTime = csound->GetScoreTime();
+    return scoreTime < lastScoreEventTime || scoreTime < sentEventsEndTime;
+}
+
+//audio thread, notes that something sent to Csound starts startDelay seconds from now
+void CsoundPluginProcessor::holdAwakeForEvents (double startDelay)
+{
+    sentEventsEndTime = jmax (sentEventsEndTime, csound->GetScoreTime() + startDelay);
+}
+
+bool CsoundPluginProcessor::performKsmps()
+{
+    //apply any host or editor channel updates that arrived since the last k-cycle
+    channelUpdateQueue.drain ([this] (int index, MYFLT value) { setControlChannel (index, value); });
+
+#ifdef Cabbage_Benchmark
+    const int64 performStartTicks = Time::getHighResolutionTicks();
+    const int result = csound->PerformKsmps();
+    performanceCounters.performKsmpsTicks += Time::getHighResolutionTicks() - performStartTicks;
+    performanceCounters.numKsmpsCalls++;
+
+    if (result != 0)
+#else
+    if (csound->PerformKsmps() != 0)
+#endif
+    {
+        disableLogging = true;
+        return false;
+    }
+
+    //slow down calls to these functions, no need for them to be firing at k-rate
+    if (guiCycles > guiRefreshRate)
+    {
+        guiCycles = 0;
+        checkStringChannelWatches();
+        triggerAsyncUpdate();
+    }
+    else
+        ++guiCycles;
+
+    //trigger any Csound score event on each k-boundary
+    triggerCsoundEvents();
+    sendHostDataToCsound();
+
+    if (numAudioTapReaders.get() > 0)
+        pushChannelTaps();
+
+    disableLogging = false;
+    return true;
+}
+
 //==============================================================================
 void CsoundPluginProcessor::breakpointCallback (CSOUND* csound, debug_bkpt_info_t* bkpt_info, void* userdata)
 {
@@ -758,26 +1410,153 @@ void CsoundPluginProcessor::breakpointCallback (CSOUND* csound, debug_bkpt_info_
 //==============================================================================
 CsoundPluginProcessor::SignalDisplay* CsoundPluginProcessor::getSignalArray (String variableName, String displayType)
 {
-    for (int i = 0; i < signalArrays.size(); i++)
+    //newest first, a caption that came back with more points than before gets a new display
+    for (int i = numSignalDisplays.get(); --i >= 0;)
     {
-        if (signalArrays[i]->caption.isNotEmpty() && signalArrays[i]->caption.contains (variableName))
+        SignalDisplay* display = signalArrays.getUnchecked (i);
+
+        if (display->caption.isNotEmpty() && display->caption.contains (variableName))
         {
             if (displayType.isEmpty())
-                return signalArrays[i];
+                return display;
+
+            else if (displayType == "waveform" && !display->caption.contains ("fft"))
+                return display;
+
+            else if (displayType == "lissajous" && !display->caption.contains ("fft"))
+                return display;
+
+            else if (displayType != "waveform" && display->caption.contains ("fft"))
+                return display;
+        }
+    }
+
+    return nullptr;
+}
+//==============================================================================
+CabbageAudioTap* CsoundPluginProcessor::addAudioTap (const String& source)
+{
+    const int numTaps = numAudioTaps.get();
+    CabbageAudioTap* tap = nullptr;
+
+    for (int i = 0; i < numTaps && tap == nullptr; ++i)
+        if (audioTaps.getUnchecked (i)->getSource() == source)
+            tap = audioTaps.getUnchecked (i);
+
+    if (tap == nullptr)
+    {
+        if (numTaps == maxAudioTaps)
+            return nullptr;
+
+        //the storage was reserved up front, so adding never moves what the audio thread reads
+        audioTaps.add (tap = new CabbageAudioTap (source));
+        numAudioTaps.set (numTaps + 1);
+        resolveAudioTapChannels();
+    }
+
+    tap->addReader();
+    ++numAudioTapReaders;
+    return tap;
+}
+
+void CsoundPluginProcessor::removeAudioTap (CabbageAudioTap* tap)
+{
+    if (tap != nullptr)
+    {
+        tap->removeReader();
+        --numAudioTapReaders;
+    }
+}
+
+//the same "input:N" and "output:N" names that audio taps use
+static bool parseMeterSource (const String& source, CabbageMeterEngine::Bus& bus, int& channel)
+{
+    const String type (source.upToFirstOccurrenceOf (":", false, false).trim());
+
+    if (type != "input" && type != "output")
+        return false;
+
+    bus = type == "input" ? CabbageMeterEngine::inputBus : CabbageMeterEngine::outputBus;
+    channel = jmax (1, source.fromFirstOccurrenceOf (":", false, false).getIntValue()) - 1;
+    return true;
+}
+
+CabbageMeterEngine::Levels* CsoundPluginProcessor::addMeterReader (const String& source)
+{
+    CabbageMeterEngine::Bus bus;
+    int channel;
+
+    if (parseMeterSource (source, bus, channel))
+        return meterEngine.addReader (bus, channel);
+
+    return nullptr;
+}
+
+void CsoundPluginProcessor::removeMeterReader (const String& source)
+{
+    CabbageMeterEngine::Bus bus;
+    int channel;
+
+    if (parseMeterSource (source, bus, channel) && isPositiveAndBelow (channel, (int) CabbageMeterEngine::maxChannelsPerBus))
+        meterEngine.removeReader (bus);
+}
+
+void CsoundPluginProcessor::resolveAudioTapChannels()
+{
+    const int generation = csoundGeneration.get();
+
+    for (int i = 0; i < numAudioTaps.get(); ++i)
+    {
+        const CabbageAudioTap* const tap = audioTaps.getUnchecked (i);
+
+        if (tap->getSourceType() != CabbageAudioTap::audioChannel || audioTapChannels[i].generation == generation)
+            continue;
+
+        MYFLT* channelPtr = nullptr;
 
-            else if (displayType == "waveform" && !signalArrays[i]->caption.contains ("fft"))
-                return signalArrays[i];
+        if (csound != nullptr && csdCompiledWithoutError())
+        {
+            if (csoundGetChannelPtr (csound->GetCsound(), &channelPtr, tap->getChannelName().toUTF8().getAddress(),
+                                     CSOUND_AUDIO_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL) != 0)
+                channelPtr = nullptr;
+        }
 
-            else if (displayType == "lissajous" && !signalArrays[i]->caption.contains ("fft"))
-                return signalArrays[i];
+        //if another instance went in while we were looking, the next swap resolves it again
+        const ScopedLock sl (getCallbackLock());
 
-            else if (displayType != "waveform" && signalArrays[i]->caption.contains ("fft"))
-                return signalArrays[i];
+        if (csoundGeneration.get() == generation)
+        {
+            audioTapChannels[i].data = channelPtr;
+            audioTapChannels[i].generation = generation;
         }
     }
+}
+
+void CsoundPluginProcessor::pushBusTaps (CabbageAudioTap::SourceType busType, const AudioSampleBuffer& buffer, int numChannels)
+{
+    for (int i = numAudioTaps.get(); --i >= 0;)
+    {
+        CabbageAudioTap* const tap = audioTaps.getUnchecked (i);
+
+        if (tap->isActive() && tap->getSourceType() == busType && tap->getBusChannel() < numChannels)
+            tap->push (buffer.getReadPointer (tap->getBusChannel()), buffer.getNumSamples());
+    }
+}
+
+void CsoundPluginProcessor::pushChannelTaps()
+{
+    const int generation = csoundGeneration.get();
 
-    return new SignalDisplay ("", -1, 0, 0, 0, 0);
+    for (int i = numAudioTaps.get(); --i >= 0;)
+    {
+        CabbageAudioTap* const tap = audioTaps.getUnchecked (i);
+        const AudioTapChannel& channel = audioTapChannels[i];
+
+        if (tap->isActive() && channel.data != nullptr && channel.generation == generation)
+            tap->push (channel.data, csdKsmps, cs_scaleInverse);
+    }
 }
+
 //==============================================================================
 bool CsoundPluginProcessor::hasEditor() const
 {
@@ -813,50 +1592,35 @@ int CsoundPluginProcessor::OpenMidiInputDevice (CSOUND* csound, void** userData,
 //==============================================================================
 // Reads MIDI input data from host, gets called every time there is MIDI input to our plugin
 //==============================================================================
-int CsoundPluginProcessor::ReadMidiData (CSOUND* /*csound*/, void* userData,
+int CsoundPluginProcessor::ReadMidiData (CSOUND* csound, void* /*userData*/,
                                          unsigned char* mbuf, int nbytes)
 {
-    CsoundPluginProcessor* midiData = (CsoundPluginProcessor*)userData;
+    //the device is opened while the instance compiles, before it has host data, so look it up each time
+    CsoundPluginProcessor* midiData = (CsoundPluginProcessor*) csoundGetHostData (csound);
 
-    if (!userData)
+    if (!midiData)
     {
         CabbageUtilities::debug ("\nInvalid");
         return 0;
     }
 
     int cnt = 0;
+    CabbageMidiRing& ring = midiData->midiInputRing;
 
-    
-    if (!midiData->midiBuffer.isEmpty() && cnt <= (nbytes - 3))
+    //only pass on events that belong to the current k-cycle, anything that doesn't fit
+    //in Csound's buffer stays queued and goes out at the start of the next one
+    while (! ring.isEmpty() && ring.front().time < midiData->midiSliceEnd)
     {
-        MidiMessage message (0xf4, 0, 0, 0);
-        MidiBuffer::Iterator i (midiData->midiBuffer);
-        int messageFrameRelativeTothisProcess;
+        const CabbageMidiRing::Event& event = ring.front();
 
-        while (i.getNextEvent (message, messageFrameRelativeTothisProcess))
-        {
-            
-            const uint8* data = message.getRawData();
-            *mbuf++ = *data++;
+        if (cnt + event.size > nbytes)
+            break;
 
-            if(message.isChannelPressure() || message.isProgramChange())
-            {
-                *mbuf++ = *data++;
-                cnt += 2;
-            }
-            else
-            {
-                *mbuf++ = *data++;
-                *mbuf++ = *data++;
-                cnt  += 3;
-            }
-        }
-
-        midiData->midiBuffer.clear();
-        
+        memcpy (mbuf + cnt, event.data, event.size);
+        cnt += event.size;
+        ring.pop();
     }
 
-    
     return cnt;
 
 }
@@ -875,10 +1639,10 @@ int CsoundPluginProcessor::OpenMidiOutputDevice (CSOUND* csound, void** userData
 // Write MIDI data to plugin's MIDI output. Each time Csound outputs a midi message this
 // method should be called. Note: you must have -Q set in your CsOptions
 //==============================================================================
-int CsoundPluginProcessor::WriteMidiData (CSOUND* /*csound*/, void* _userData,
+int CsoundPluginProcessor::WriteMidiData (CSOUND* csound, void* /*_userData*/,
                                           const unsigned char* mbuf, int nbytes)
 {
-    CsoundPluginProcessor* userData = (CsoundPluginProcessor*)_userData;
+    CsoundPluginProcessor* userData = (CsoundPluginProcessor*) csoundGetHostData (csound);
 
     if (!userData)
     {
@@ -886,8 +1650,22 @@ int CsoundPluginProcessor::WriteMidiData (CSOUND* /*csound*/, void* _userData,
         return 0;
     }
 
-    MidiMessage message (mbuf, nbytes, 0);
-    userData->midiOutputBuffer.addEvent (message, 0);
+    //mbuf may hold more than one message, split it so each can be queued on its own,
+    //sysex and running status bytes are not passed on
+    for (int i = 0; i < nbytes;)
+    {
+        if (mbuf[i] < 0x80 || mbuf[i] == 0xf0 || mbuf[i] == 0xf7)
+            break;
+
+        const int size = MidiMessage::getMessageLengthFromFirstByte (mbuf[i]);
+
+        if (i + size > nbytes)
+            break;
+
+        userData->midiOutputRing.push (userData->midiOutputOffset, mbuf + i, size);
+        i += size;
+    }
+
     return nbytes;
 }
 
@@ -895,31 +1673,51 @@ int CsoundPluginProcessor::WriteMidiData (CSOUND* /*csound*/, void* _userData,
 // graphing functions...
 //===========================================================================================
 
+//Csound only calls this when an opcode sets up a display whose windid is still 0, the id
+//handed back is the display's slot plus one so drawGraphCallback() needs no caption search
 void CsoundPluginProcessor::makeGraphCallback (CSOUND* csound, WINDAT* windat, const char* /*name*/)
 {
     CsoundPluginProcessor* ud = (CsoundPluginProcessor*) csoundGetHostData (csound);
-    SignalDisplay* display = new SignalDisplay (String (windat->caption), windat->windid, windat->oabsmax, windat->min, windat->max, windat->npts);
 
-    bool addDisplay = true;
+    //an instance that isn't installed yet gets no display
+    if (ud == nullptr)
+    {
+        windat->windid = 0;
+        return;
+    }
+
+    const String caption (windat->caption);
+    const int numDisplays = ud->numSignalDisplays.get();
 
-    for (int i = 0; i < ud->signalArrays.size(); i++)
+    for (int i = numDisplays; --i >= 0;)
     {
-        if (ud->signalArrays[i]->caption == windat->caption)
-            addDisplay  = false;
+        const SignalDisplay* display = ud->signalArrays.getUnchecked (i);
+
+        if (display->caption == caption && display->buffer.getCapacity() >= windat->npts)
+        {
+            windat->windid = (uintptr_t) (i + 1);
+            return;
+        }
     }
 
-    if (addDisplay)
-        ud->signalArrays.add (display);
+    if (numDisplays == maxSignalDisplays)
+    {
+        windat->windid = 0;
+        return;
+    }
+
+    ud->signalArrays.add (new SignalDisplay (caption, numDisplays + 1, windat->oabsmax, windat->min, windat->max, windat->npts));
+    windat->windid = (uintptr_t) (numDisplays + 1);
+    ud->numSignalDisplays.set (numDisplays + 1);
 }
 
 void CsoundPluginProcessor::drawGraphCallback (CSOUND* csound, WINDAT* windat)
 {
     CsoundPluginProcessor* ud = (CsoundPluginProcessor*) csoundGetHostData (csound);
-    Array<float, CriticalSection> tablePoints;
-    //only take all samples if dealing with fft, waveforms and lissajous curves can be drawn with less samples
-    tablePoints = Array<float, CriticalSection> (&windat->fdata[0], windat->npts);
-    ud->getSignalArray (windat->caption)->setPoints (tablePoints);
-    ud->updateSignalDisplay = true;
+    const int index = (int) windat->windid - 1;
+
+    if (ud != nullptr && isPositiveAndBelow (index, ud->numSignalDisplays.get()))
+        ud->signalArrays.getUnchecked (index)->buffer.publish (windat->fdata, windat->npts);
 }
 
 void CsoundPluginProcessor::killGraphCallback (CSOUND* csound, WINDAT* windat)
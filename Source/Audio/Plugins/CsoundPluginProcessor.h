@@ -27,6 +27,12 @@
 #include <cwindow.h>
 #include "../../Utilities/CabbageUtilities.h"
 #include "CabbageCsoundBreakpointData.h"
+#include "CabbageChannelUpdateQueue.h"
+#include "CabbageEventMatrix.h"
+#include "CabbageMidiRing.h"
+#include "CabbageSignalBuffer.h"
+#include "CabbageAudioTap.h"
+#include "CabbageMeterEngine.h"
 #ifdef CabbagePro
 #include "../../Utilities/encrypt.h"
 #endif
@@ -42,7 +48,14 @@ public:
     //==============================================================================
     //pass the path to the temp file, along with the path to the original csd file so we can set correct working dir
 	bool setupAndCompileCsound(File csdFile, File filePath, int sr = 44100, bool debugMode = false);
+    //compiles the last compiled file again at the current sample rate on a background thread,
+    //the audio thread swaps the new instance in once it is ready and fades it in
+    void compileCsoundInBackground (bool muteUntilReady);
+    //as above for a new file, csdFile is compiled with filePath as the folder Csound looks in for files
+    void compileCsoundInBackground (File csdFile, File filePath, bool muteUntilReady);
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    //non-virtual so that processors overriding prepareToPlay can share the per-rate setup
+    void prepareAudioAnalysis (double sampleRate);
     void releaseResources() override;
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
@@ -118,8 +131,10 @@ public:
 
     };
 
-    void createMatrixEventSequencer(int rows, int cols, String channel);
-    void setMatrixEventSequencerCellData(int row, int col, String channel, String data);
+    void createMatrixEventSequencer(int cols, int rows, String channel);
+    void setMatrixEventSequencerCellData(int col, int row, String channel, String data);
+    //vertical sequencers step through rows, horizontal ones through columns
+    virtual bool isEventMatrixVertical (const String& channel) { return false; }
     //=============================================================================
     //Implement these to init, send and receive channel data to Csound. Typically used when
     //a component is updated and its value is sent to Csound, or when a Csound channel
@@ -130,7 +145,12 @@ public:
     virtual void sendChannelDataToCsound() {};
     void sendHostDataToCsound();
     virtual void getChannelDataFromCsound() {};
-    virtual void initAllCsoundChannels (ValueTree cabbageData);
+    virtual void initAllCsoundChannels (ValueTree cabbageData, Csound* target = nullptr);
+    //called on the message thread when a background compile starts, returns a copy of whatever
+    //initAllCsoundChannels() should be given for the new instance
+    virtual ValueTree getChannelInitialisationData() { return ValueTree(); }
+    //called on the message thread once the audio thread has swapped in a new instance
+    virtual void csoundInstanceSwapped() {}
     //=============================================================================
     void addMacros (String csdText);
     const String getCsoundOutput();
@@ -167,6 +187,31 @@ public:
         guiRefreshRate = rate;
     }
 
+    //set through form's idletime() identifier, once input and output have been silent for this
+    //many seconds, with no MIDI or channel activity, Csound stops being performed until they aren't
+    void setIdleTime (double seconds)
+    {
+        idleTime = jmax (0.0, seconds);
+    }
+
+    //call after handing Csound anything the audio thread can't see, score events for instance.
+    //Csound is kept awake until startDelay seconds of score time have passed, so events that
+    //start later aren't slept through
+    void wakeFromIdle (double startDelay = 0.0) noexcept
+    {
+        if (startDelay > idleWakeStartDelay.get())
+            idleWakeStartDelay = startDelay;
+
+        idleWakeRequested = 1;
+    }
+
+    //proportion of k-cycles that were skipped while idle since the instrument was compiled
+    double getSkippedCycleRatio() const noexcept
+    {
+        const int64 total = idleSkippedSamples.get() + idlePerformedSamples.get();
+        return total > 0 ? idleSkippedSamples.get() / (double) total : 0.0;
+    }
+
 
 
     int getNumberOfCsoundChannels()
@@ -174,15 +219,79 @@ public:
         return numCsoundChannels;
     }
 
+    //=============================================================================
+    //Control channels are resolved to Csound's own channel pointers once after each compile
+    //and kept in a flat table. Indices handed out by getControlChannelIndex() remain valid
+    //across recompiles, so hot paths can hold on to an int rather than a channel name.
+    int getControlChannelIndex (const String& channelName);
+    void resolveControlChannelPointers();
+    void setControlChannel (int index, MYFLT value);
+    MYFLT getControlChannel (int index) const;
+
+    //safe to call from any thread, the update is applied by the audio thread at the next k-boundary
+    void queueControlChannelUpdate (int index, MYFLT value);
+
+    //String channels the GUI reads are checked by the audio thread each time it triggers a GUI
+    //update, and a channel's version changes whenever its text does, so the message thread only
+    //copies out the channels that were written. Returns -1 once the table is full.
+    int watchStringChannel (const String& channelName);
+    //true if the channel may have changed since lastVersion, which is then updated. Unwatched
+    //channels, i.e, an index of -1, always count as changed
+    bool hasStringChannelChanged (int index, int& lastVersion) const;
+
+    const CabbageChannelUpdateQueue& getChannelUpdateQueue() const
+    {
+        return channelUpdateQueue;
+    }
+
+    const CabbageMidiRing& getMidiInputRing() const
+    {
+        return midiInputRing;
+    }
+
+    const CabbageMidiRing& getMidiOutputRing() const
+    {
+        return midiOutputRing;
+    }
+
+    MYFLT* getControlChannelPointer (int index) const
+    {
+        return controlChannelPointers[index];
+    }
+
+    //forces a ksmps value on the next compile, 0 leaves it to the .csd file
+    void setKsmpsOverride (int ksmps)
+    {
+        ksmpsOverride = ksmps;
+    }
+
+#ifdef Cabbage_Benchmark
+    //time spent compiling and inside Csound's own k-cycles, so benchmarks can tell Csound apart from Cabbage
+    struct PerformanceCounters
+    {
+        int numCompiles = 0;
+        int64 lastCompileTicks = 0;
+        int64 performKsmpsTicks = 0;
+        int64 numKsmpsCalls = 0;
+    };
+
+    const PerformanceCounters& getPerformanceCounters() const
+    {
+        return performanceCounters;
+    }
+#endif
+
     MidiKeyboardState keyboardState;
 
     //==================================================================================
+    //one per graph caption, registered by makeGraphCallback() and kept until the processor goes
     class SignalDisplay
     {
     public:
         float yScale;
         int windid, min , max, size;
         String caption;
+        CabbageSignalBuffer buffer;
 
         SignalDisplay (String _caption, int _id, float _scale, int _min, int _max, int _size):
             caption (_caption),
@@ -190,51 +299,66 @@ public:
             yScale (_scale),
             min (_min),
             max (_max),
-            size (_size)
+            size (_size),
+            buffer (_size)
         {}
-
-        ~SignalDisplay()
-        {
-            points.clear();
-        }
-
-        Array<float, CriticalSection> getPoints()
-        {
-            return points;
-        }
-
-        void setPoints (Array <float, CriticalSection > tablePoints)
-        {
-            points.swapWith (tablePoints);
-        }
-
-    private:
-        Array <float, CriticalSection > points;
-    };
-
-    bool shouldUpdateSignalDisplay()
-    {
-        bool returnVal = updateSignalDisplay;
-        updateSignalDisplay = false;
-        return returnVal;
     };
 
     OwnedArray<MatrixEventSequencer> matrixEventSequencers;
-    OwnedArray <SignalDisplay, CriticalSection> signalArrays;   //holds values from FFT function table created using dispfft
+    //the pointer storage is reserved up front and only the first numSignalDisplays entries are
+    //ever read, so the GUI can look displays up while Csound registers new ones
+    enum { maxSignalDisplays = 64 };
+    OwnedArray<SignalDisplay> signalArrays;
+    Atomic<int> numSignalDisplays;
+    int getNumSignalDisplays() const noexcept { return numSignalDisplays.get(); }
+    //message thread, returns nullptr when no graph matches
     CsoundPluginProcessor::SignalDisplay* getSignalArray (String variableName, String displayType = "");
 
+    //==================================================================================
+    //message thread, a tap is created the first time its source is asked for and is kept until
+    //the processor goes, its samples are only copied while someone holds it. Returns nullptr
+    //once maxAudioTaps different sources are in use
+    enum { maxAudioTaps = 32 };
+    CabbageAudioTap* addAudioTap (const String& source);
+    void removeAudioTap (CabbageAudioTap* tap);
+
+    //message thread, binds a meter to "input:N" or "output:N", returns nullptr for anything else
+    CabbageMeterEngine::Levels* addMeterReader (const String& source);
+    void removeMeterReader (const String& source);
+
 private:
     //==============================================================================
-    MidiBuffer midiOutputBuffer;
+    //runs a single k-cycle and services the k-rate housekeeping, returns false once Csound has stopped
+    bool performKsmps();
+    //audio thread, copy the current block or k-cycle into every tap that is being read
+    void pushBusTaps (CabbageAudioTap::SourceType busType, const AudioSampleBuffer& buffer, int numChannels);
+    void pushChannelTaps();
+    //a-rate channel data belongs to one Csound instance, the pointers are looked up again
+    //whenever a new instance is installed and ignored until then
+    void resolveAudioTapChannels();
+    struct AudioTapChannel
+    {
+        MYFLT* data;
+        int generation;
+    };
+    OwnedArray<CabbageAudioTap> audioTaps;
+    CabbageMeterEngine meterEngine;
+    HeapBlock<AudioTapChannel> audioTapChannels;
+    Atomic<int> numAudioTaps, numAudioTapReaders, csoundGeneration;
+    //MIDI written by Csound, stamped with the block offset of the k-cycle that produced it
+    CabbageMidiRing midiOutputRing;
+    int midiOutputOffset = 0;
     int guiCycles = 0;
     int guiRefreshRate = 128;
-    MidiBuffer midiBuffer;
+    //host MIDI waiting to be handed to Csound, ReadMidiData only passes on the events that
+    //fall before midiSliceEnd, the end of the k-cycle currently being performed
+    CabbageMidiRing midiInputRing;
+    int64 midiBlockStart = 0, midiSliceEnd = 0;
     String csoundOutput;
     ScopedPointer<CSOUND_PARAMS> csoundParams;
     int csCompileResult = -1;
     int numCsoundChannels, pos;
-    bool updateSignalDisplay = false;
-    MYFLT cs_scale;
+    MYFLT cs_scale, cs_scaleInverse;
     MYFLT* CSspin, *CSspout;
     int samplingRate = 44100;
     int csndIndex;
@@ -244,6 +368,97 @@ private:
     ScopedPointer<FileLogger> fileLogger;
     int busIndex = 0;
     bool disableLogging = false;
+    int ksmpsOverride = 0;
+    File compiledCsdFile;
+
+    //everything a compile produces, built off the audio thread and then swapped into the
+    //processor in one go, after which it holds the instance that was replaced
+    struct CsoundInstance
+    {
+        ScopedPointer<Csound> csound;
+        ScopedPointer<CSOUND_PARAMS> params;
+        int compileResult = -1;
+        int numChannels = 0;
+        double lastScoreEventTime = 0;
+        Array<MYFLT*> channelPointers;
+    };
+
+    CsoundInstance* createCsoundInstance (File csdFile, File filePath, int sr, bool debugMode, const StringArray& channelNames);
+    void installCsoundInstance (CsoundInstance& instance);
+    void swapInReadyInstance();
+
+    struct CompileThreadPool : public ThreadPool
+    {
+        CompileThreadPool() : ThreadPool (1) {}
+    };
+
+    class CompileJob;
+    struct CompileJobSelector;
+    SharedResourcePointer<CompileThreadPool> compileThreadPool;
+    Atomic<CsoundInstance*> readyInstance { nullptr }, retiredInstance { nullptr };
+    Atomic<int> muteUntilSwap { 0 };
+    bool fadeOutBeforeSwap = false;
+
+    //checks this block for any sign of life and returns true if Csound can sleep through it
+    bool isIdleBlock (const AudioSampleBuffer& buffer, const MidiBuffer& midiMessages);
+    bool hasPendingCsoundEvents() const;
+    void holdAwakeForEvents (double startDelay);
+    double idleTime = 0.0;
+    double lastScoreEventTime = 0.0;
+    //score time at which the latest event sent while Csound was running starts
+    double sentEventsEndTime = 0.0;
+    int64 silentSamples = 0;
+    float lastOutputPeak = 0.f;
+    Atomic<int> idleWakeRequested { 0 };
+    Atomic<double> idleWakeStartDelay { 0.0 };
+    Atomic<int64> idleSkippedSamples { 0 }, idlePerformedSamples { 0 };
+
+    //the sequencers' cells compiled for the audio thread, rebuilt on the message thread
+    //whenever a cell changes and swapped in under a lock the audio thread never waits on
+    void compileEventMatrix();
+    ScopedPointer<CabbageEventMatrix> eventMatrix;
+    SpinLock eventMatrixLock;
+    bool eventMatrixChanged = false;
+#ifdef Cabbage_Benchmark
+    PerformanceCounters performanceCounters;
+#endif
+
+    enum HostChannels
+    {
+        hostBpmChannel = 0,
+        timeInSecondsChannel,
+        isPlayingChannel,
+        isRecordingChannel,
+        hostPpqPosChannel,
+        timeInSamplesChannel,
+        timeSigDenomChannel,
+        timeSigNumChannel,
+        numHostChannels
+    };
+
+    struct StringChannelWatch
+    {
+        String name;
+        bool exists = false;
+        HeapBlock<char> text;       //the channel's text as last copied out, sized on the message thread
+        int textSize = 0;
+        int generation = -1;
+        uint64 lastHash = 0;        //audio thread only once resolved
+        Atomic<int> version;
+    };
+
+    enum { maxStringChannelWatches = 256 };
+    void resolveStringChannelWatches();
+    void checkStringChannelWatches();
+    OwnedArray<StringChannelWatch> stringChannelWatches;
+    HashMap<String, int> stringChannelWatchIndexes;
+    Atomic<int> numStringChannelWatches;
+
+    StringArray controlChannelNames;
+    HashMap<String, int> controlChannelIndexes;
+    Array<MYFLT*> controlChannelPointers;
+    CabbageChannelUpdateQueue channelUpdateQueue;
+    int hostChannelIndexes[numHostChannels];
 
 
 
@@ -358,6 +358,8 @@ public:
         add ("updaterate");
         add ("gapmarkers");
         add ("guirefresh");
+        add ("idletime");
+        add ("logscale");
         add ("tablecolor");
         add ("radiogroup");
         add ("macronames");
@@ -434,6 +436,8 @@ public:
         add ("max");
         add ("pos");
         add ("bpm");
+        add ("tap");
+        add ("metersource");
     }
 };
 
@@ -543,6 +547,7 @@ namespace CabbageIdentifierIds
 	static const Identifier height = "height";
 	static const Identifier highlightcolour = "highlightcolour";
 	static const Identifier identchannel = "identchannel";
+	static const Identifier idletime = "idletime";
 	static const Identifier identchannelarray = "identchannelarray";
 	static const Identifier identchannelmessage = "identchannelmessage";
 	static const Identifier imgbuttonoff = "imgbuttonoff";
@@ -567,6 +572,7 @@ namespace CabbageIdentifierIds
 	static const Identifier linenumber = "linenumber";
 	static const Identifier linethickness = "linethickness";
 	static const Identifier logger = "logger";
+	static const Identifier logscale = "logscale";
 	static const Identifier macrostrings = "macrostrings";
     static const Identifier markercolour = "markercolour";
     static const Identifier markerend = "markerend";
@@ -580,6 +586,7 @@ namespace CabbageIdentifierIds
 	static const Identifier maxx = "maxx";
 	static const Identifier maxy = "maxy";
 	static const Identifier menucolour = "menucolour";
+	static const Identifier metersource = "metersource";
 	static const Identifier metercolour = "metercolour";
 	static const Identifier middlec = "middlec";
 	static const Identifier midichan = "midichan";
@@ -647,6 +654,7 @@ namespace CabbageIdentifierIds
 	static const Identifier tableconfig = "tableconfig";
 	static const Identifier tablegridcolour = "tablegridcolour";
 	static const Identifier tablenumber = "tablenumber";
+	static const Identifier tap = "tap";
 	static const Identifier tabpage = "tabpage";
 	static const Identifier tabs = "tabs";
 	static const Identifier text = "text";
@@ -874,9 +882,9 @@ static const char* const CsoundKeywords[] =
     "transegr", "trcross", "trfilter", "trhighest", "trlowest", "trmix", "trscale", "trshift", "trsplit", "urandom", "vadd_i", "vaddv_i", "vaget", "vaset", "vbap", "vbapmove", "vbapg", "vbapgmove", "vdivv_i",
     "vexp_i", "vexpv_i", "vmult_i", "vmultv_i", "vosim", "vphaseseg", "vpow_i", "vpowv_i", "vsubv_i", "vtable1k", "wiiconnect", "wiidata", "wiirange", "wiisend", "writescratch", "encoder", "fftdisplay", "keyboard", "label",
     "listbox", "hrange", "vrange", "active", "align", "alpha", "amprange", "bounds", "caption", "channel", "channelarray", "channeltype", "child", "colour", "colour:0", "colour:1", "corners", "displaytype", "file",
-    "fontcolour", "fontstyle", "guirefresh", "highlightcolour", "identchannel", "items", "latched", "line", "middlec", "max", "min", "mode", "outlinecolour", "outlinethickness", "plant", "pluginid", "populate",
+    "fontcolour", "fontstyle", "guirefresh", "highlightcolour", "identchannel", "idletime", "items", "latched", "line", "middlec", "max", "min", "mode", "outlinecolour", "outlinethickness", "plant", "pluginid", "populate",
     "popup", "popuptext", "range", "rangex", "rangey", "rotate", "samplerange", "scrubberpos", "scrubberposition", "shape", "show", "size", "sliderincr", "svgfile", "svgpath", "tablebackgroundcolour", "tablecolour",
-    "tablegridcolour", "tablenumber", "text", "textcolour", "textbox", "trackercolour", "trackerthickness", "trackerouterradius", "trackerinnerradius", "typeface", "widgetarray", "wrap", "value", "velocity", "visible", "zoom", "zkwm", "maxarray", "fillarray", "lenarray",
+    "tablegridcolour", "tablenumber", "text", "textcolour", "textbox", "trackercolour", "trackerthickness", "trackerouterradius", "trackerinnerradius", "typeface", "widgetarray", "wrap", "value", "velocity", "visible", "zoom", "logscale", "tap", "metersource", "zkwm", "maxarray", "fillarray", "lenarray",
     "od", "gentable", "texteditor", "textbox", "sprintfk", "strcpyk", "sprintf", "strcmpk", "strcmp", "a", "abetarand", "abexprnd", "infobutton", "groupbox", "do", "popupmenu", "filebutton", "until",
     "enduntil", "soundfiler", "combobox", "vslider", "vslider2", "vslider3", "hslider2", "define", "hslider3", "hslider", "rslider", "groupbox", "combobox", "xypad", "image", "plant", "csoundoutput", "button", "form", "checkbox",
     "tab", "abs", "acauchy", "active", "adsr", "adsyn", "adsynt", "adsynt2", "aexprand", "aftouch", "agauss", "agogobel", "alinrand", "alpass", "ampdb", "ampdbfs", "ampmidi", "apcauchy", "apoisson", "apow", "areson",
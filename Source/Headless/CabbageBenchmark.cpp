@@ -0,0 +1,432 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Audio/Plugins/CabbagePluginProcessor.h"
+
+//==============================================================================
+// CabbageBenchmark - runs .csd instruments through CabbagePluginProcessor, with no
+// editor or audio device, and measures where the time goes. Every instrument is
+// run at each combination of sample rate, ksmps and block size given.
+//
+// Usage:
+// CabbageBenchmark [options]
+//      --examples dir          folder searched recursively for .csd files, defaults to Examples
+//      --filter text,...       only run files whose path contains one of these
+//      --samplerates list      comma separated, defaults to 44100
+//      --ksmps list            comma separated, 0 uses the .csd file's own value, defaults to 0
+//      --blocksizes list       comma separated, defaults to 64,512
+//      --duration seconds      audio rendered per run, defaults to 2
+//      --output file           write the results as JSON
+//      --baseline file         compare against JSON results from an earlier run
+//      --tolerance percent     slow down allowed before a run counts as a regression, defaults to 10
+//      --parse passes          time parsing every widget line of the Cabbage sections instead,
+//                              taking the median of this many passes over all the files
+//
+// Exits with 2 if any run regressed against the baseline.
+//==============================================================================
+
+namespace
+{
+    struct BenchmarkSettings
+    {
+        double sampleRate;
+        int ksmps, blockSize;
+    };
+
+    struct BenchmarkResult
+    {
+        String file;
+        BenchmarkSettings settings;
+        bool compiled = false;
+        double loadMs = 0, parseMs = 0, compileMs = 0;
+        double meanBlockUs = 0, p99BlockUs = 0;
+        double performKsmpsUsPerBlock = 0, glueUsPerBlock = 0;
+        double meanChannelDataUs = 0;
+        double realTimeFactor = 0;
+
+        String getKey() const
+        {
+            return file + "|" + String (settings.sampleRate) + "|" + String (settings.ksmps) + "|" + String (settings.blockSize);
+        }
+
+        var toVar() const
+        {
+            DynamicObject::Ptr obj = new DynamicObject();
+            obj->setProperty ("file", file);
+            obj->setProperty ("sampleRate", settings.sampleRate);
+            obj->setProperty ("ksmps", settings.ksmps);
+            obj->setProperty ("blockSize", settings.blockSize);
+            obj->setProperty ("compiled", compiled);
+            obj->setProperty ("loadMs", loadMs);
+            obj->setProperty ("parseMs", parseMs);
+            obj->setProperty ("compileMs", compileMs);
+            obj->setProperty ("meanBlockUs", meanBlockUs);
+            obj->setProperty ("p99BlockUs", p99BlockUs);
+            obj->setProperty ("performKsmpsUsPerBlock", performKsmpsUsPerBlock);
+            obj->setProperty ("glueUsPerBlock", glueUsPerBlock);
+            obj->setProperty ("meanChannelDataUs", meanChannelDataUs);
+            obj->setProperty ("realTimeFactor", realTimeFactor);
+            return var (obj.get());
+        }
+    };
+
+    double ticksToMicroseconds (int64 ticks)
+    {
+        return Time::highResolutionTicksToSeconds (ticks) * 1000000.0;
+    }
+
+    Array<int> parseIntList (const String& list)
+    {
+        StringArray tokens;
+        tokens.addTokens (list, ",", "");
+        tokens.removeEmptyStrings();
+
+        Array<int> values;
+
+        for (auto& token : tokens)
+            values.add (token.getIntValue());
+
+        return values;
+    }
+
+    String getOption (const StringArray& args, const String& name, const String& defaultValue = String())
+    {
+        const int index = args.indexOf (name);
+        return (index >= 0 && index < args.size() - 1) ? args[index + 1] : defaultValue;
+    }
+
+    //==============================================================================
+    // renders 'duration' seconds at one block size, timing every processBlock call
+    void runBlockSize (CabbagePluginProcessor& processor, BenchmarkResult& result, double duration)
+    {
+        const BenchmarkSettings& settings = result.settings;
+        const int numChannels = jmax (processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        AudioBuffer<float> buffer (numChannels, settings.blockSize);
+        MidiBuffer midiBuffer;
+
+        const int numBlocks = jmax (1, (int) (duration * settings.sampleRate / settings.blockSize));
+        const int numWarmUpBlocks = jmin (16, numBlocks / 10);
+        Array<double> blockTimes;
+        blockTimes.ensureStorageAllocated (numBlocks);
+        int64 channelDataTicks = 0;
+
+        const CsoundPluginProcessor::PerformanceCounters& counters = processor.getPerformanceCounters();
+        int64 performTicksAtStart = 0;
+
+        for (int block = -numWarmUpBlocks; block < numBlocks; block++)
+        {
+            midiBuffer.clear();
+
+            //hold a chord so instruments that need MIDI make some sound
+            if (block == -numWarmUpBlocks)
+                for (int note : { 60, 64, 67 })
+                    midiBuffer.addEvent (MidiMessage::noteOn (1, note, (uint8) 100), 0);
+
+            if (block == 0)
+                performTicksAtStart = counters.performKsmpsTicks;
+
+            buffer.clear();
+
+            const int64 start = Time::getHighResolutionTicks();
+            processor.processBlock (buffer, midiBuffer);
+            const int64 end = Time::getHighResolutionTicks();
+
+            //normally triggered from the audio thread and run on the message thread
+            processor.getChannelDataFromCsound();
+
+            if (block >= 0)
+            {
+                blockTimes.add (ticksToMicroseconds (end - start));
+                channelDataTicks += Time::getHighResolutionTicks() - end;
+            }
+        }
+
+        double totalUs = 0;
+
+        for (auto t : blockTimes)
+            totalUs += t;
+
+        blockTimes.sort();
+
+        result.meanBlockUs = totalUs / numBlocks;
+        result.p99BlockUs = blockTimes[jmax (0, roundToInt (std::ceil (numBlocks * 0.99)) - 1)];
+        result.performKsmpsUsPerBlock = ticksToMicroseconds (counters.performKsmpsTicks - performTicksAtStart) / numBlocks;
+        result.glueUsPerBlock = result.meanBlockUs - result.performKsmpsUsPerBlock;
+        result.meanChannelDataUs = ticksToMicroseconds (channelDataTicks) / numBlocks;
+        result.realTimeFactor = (numBlocks * settings.blockSize / settings.sampleRate) / (totalUs / 1000000.0);
+    }
+
+    //one processor per file, sample rate and ksmps, each block size is run on it in turn
+    void runFile (const File& csdFile, const String& name, double sampleRate, int ksmps, const Array<int>& blockSizes,
+                  double duration, Array<BenchmarkResult>& results)
+    {
+        BenchmarkResult result;
+        result.file = name;
+        result.settings = { sampleRate, ksmps, 0 };
+
+        const int numChannels = CsdDocument::forFile (csdFile)->getHeaderInfo ("nchnls");
+        const int64 loadStart = Time::getHighResolutionTicks();
+        ScopedPointer<CabbagePluginProcessor> processor (new CabbagePluginProcessor (csdFile, numChannels, numChannels));
+        result.loadMs = ticksToMicroseconds (Time::getHighResolutionTicks() - loadStart) / 1000.0;
+        result.parseMs = result.loadMs - ticksToMicroseconds (processor->getPerformanceCounters().lastCompileTicks) / 1000.0;
+
+        const int numCompiles = processor->getPerformanceCounters().numCompiles;
+        int maxBlockSize = 0;
+
+        for (auto size : blockSizes)
+            maxBlockSize = jmax (maxBlockSize, size);
+
+        processor->setKsmpsOverride (ksmps);
+        //compile in place rather than in the background, the timing needs the new instance straight away
+        processor->setNonRealtime (true);
+        processor->setPlayConfigDetails (processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels(), sampleRate, maxBlockSize);
+        processor->prepareToPlay (sampleRate, maxBlockSize);
+
+        //prepareToPlay only recompiles when the sample rate changes
+        if (ksmps > 0 && processor->getPerformanceCounters().numCompiles == numCompiles)
+            processor->createCsound (csdFile, false);
+
+        result.compileMs = ticksToMicroseconds (processor->getPerformanceCounters().lastCompileTicks) / 1000.0;
+        result.compiled = processor->csdCompiledWithoutError();
+
+        for (auto blockSize : blockSizes)
+        {
+            result.settings.blockSize = blockSize;
+
+            if (result.compiled)
+            {
+                const ScopedLock sl (processor->getCallbackLock());
+                runBlockSize (*processor, result, duration);
+            }
+
+            results.add (result);
+        }
+
+        processor->releaseResources();
+    }
+
+    //==============================================================================
+    // parses every widget line with CabbageWidgetData::setWidgetState(), the work behind opening
+    // an editor, each live update in the IDE and every identchannel message
+    void runParseBenchmark (const Array<File>& csdFiles, int numPasses)
+    {
+        StringArray widgetLines;
+
+        for (auto& csdFile : csdFiles)
+        {
+            const CsdDocument::Ptr csd = CsdDocument::forFile (csdFile);
+            const Range<int> section = csd->getSection (CsdDocument::cabbageSection);
+
+            for (int i = section.getStart(); i < section.getEnd(); i++)
+            {
+                const String line = csd->getLines()[i].trim();
+
+                if (line.isNotEmpty() && ! line.startsWithChar (';') && ! line.startsWithChar ('#'))
+                    widgetLines.add (line);
+            }
+        }
+
+        Array<double> passTimes;
+
+        //the first pass only warms up the identifier pool and caches
+        for (int pass = -1; pass < numPasses; pass++)
+        {
+            const int64 start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < widgetLines.size(); i++)
+            {
+                ValueTree widget ("widget");
+                CabbageWidgetData::setWidgetState (widget, widgetLines[i], i);
+            }
+
+            if (pass >= 0)
+                passTimes.add (ticksToMicroseconds (Time::getHighResolutionTicks() - start));
+        }
+
+        passTimes.sort();
+        const double medianUs = passTimes[passTimes.size() / 2];
+
+        std::cout << widgetLines.size() << " widget lines from " << csdFiles.size() << " files" << std::endl
+                  << "median pass " << String (medianUs / 1000.0, 2) << " ms, fastest " << String (passTimes.getFirst() / 1000.0, 2)
+                  << " ms, " << String (medianUs / jmax (1, widgetLines.size()), 2) << " us per line" << std::endl;
+    }
+
+    void printResult (const BenchmarkResult& r)
+    {
+        String line = r.file.paddedRight (' ', 48)
+                    + String (r.settings.sampleRate, 0).paddedLeft (' ', 7)
+                    + String (r.settings.ksmps).paddedLeft (' ', 6)
+                    + String (r.settings.blockSize).paddedLeft (' ', 7);
+
+        if (r.compiled)
+            line << String (r.loadMs, 1).paddedLeft (' ', 9)
+                 << String (r.compileMs, 1).paddedLeft (' ', 9)
+                 << String (r.meanBlockUs, 1).paddedLeft (' ', 10)
+                 << String (r.p99BlockUs, 1).paddedLeft (' ', 10)
+                 << String (r.performKsmpsUsPerBlock, 1).paddedLeft (' ', 10)
+                 << String (r.glueUsPerBlock, 1).paddedLeft (' ', 10)
+                 << String (r.meanChannelDataUs, 1).paddedLeft (' ', 10)
+                 << String (r.realTimeFactor, 1).paddedLeft (' ', 9);
+        else
+            line << "   failed to compile";
+
+        std::cout << line << std::endl;
+    }
+
+    //returns the number of runs that are slower than the baseline by more than the tolerance
+    int compareWithBaseline (const Array<BenchmarkResult>& results, const File& baselineFile, double tolerance)
+    {
+        const var baseline = JSON::parse (baselineFile);
+
+        if (! baseline.isArray())
+        {
+            std::cerr << "Could not read baseline " << baselineFile.getFullPathName() << std::endl;
+            return 0;
+        }
+
+        HashMap<String, var> baselineRuns;
+
+        for (auto& run : *baseline.getArray())
+        {
+            BenchmarkResult key;
+            key.file = run["file"];
+            key.settings = { double (run["sampleRate"]), int (run["ksmps"]), int (run["blockSize"]) };
+            baselineRuns.set (key.getKey(), run);
+        }
+
+        int numRegressions = 0;
+        std::cout << std::endl << "Compared with " << baselineFile.getFileName() << ":" << std::endl;
+
+        for (auto& r : results)
+        {
+            if (! r.compiled || ! baselineRuns.contains (r.getKey()))
+                continue;
+
+            const var run = baselineRuns[r.getKey()];
+            const double meanChange = 100.0 * (r.meanBlockUs / jmax (0.001, double (run["meanBlockUs"])) - 1.0);
+            const double p99Change = 100.0 * (r.p99BlockUs / jmax (0.001, double (run["p99BlockUs"])) - 1.0);
+            const bool regressed = meanChange > tolerance || p99Change > tolerance;
+
+            if (regressed)
+                numRegressions++;
+
+            std::cout << (r.file + " " + String (r.settings.blockSize)).paddedRight (' ', 56)
+                      << " mean " << String (meanChange, 1) << "%, p99 " << String (p99Change, 1) << "%"
+                      << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+
+        return numRegressions;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    StringArray args;
+
+    for (int i = 1; i < argc; i++)
+        args.add (CharPointer_UTF8 (argv[i]));
+
+    const File examplesDir = File::getCurrentWorkingDirectory().getChildFile (getOption (args, "--examples", "Examples"));
+    const Array<int> sampleRates = parseIntList (getOption (args, "--samplerates", "44100"));
+    const Array<int> ksmpsValues = parseIntList (getOption (args, "--ksmps", "0"));
+    const Array<int> blockSizes = parseIntList (getOption (args, "--blocksizes", "64,512"));
+    const double duration = getOption (args, "--duration", "2").getDoubleValue();
+    const double tolerance = getOption (args, "--tolerance", "10").getDoubleValue();
+    const int parsePasses = getOption (args, "--parse", "0").getIntValue();
+
+    StringArray filters;
+    filters.addTokens (getOption (args, "--filter"), ",", "");
+    filters.removeEmptyStrings();
+
+    if (! examplesDir.isDirectory() || sampleRates.isEmpty() || ksmpsValues.isEmpty() || blockSizes.isEmpty() || duration <= 0)
+    {
+        std::cout << "Usage: CabbageBenchmark [--examples dir] [--filter text,...] [--samplerates list] [--ksmps list]" << std::endl
+                  << "       [--blocksizes list] [--duration seconds] [--output file] [--baseline file] [--tolerance percent]" << std::endl
+                  << "       [--parse passes]" << std::endl;
+        return 1;
+    }
+
+    Array<File> allFiles, csdFiles;
+    examplesDir.findChildFiles (allFiles, File::findFiles, true, "*.csd");
+    allFiles.sort();
+
+    for (auto& csdFile : allFiles)
+    {
+        const String name = csdFile.getRelativePathFrom (examplesDir).replaceCharacter ('\\', '/');
+        bool included = filters.isEmpty();
+
+        for (auto& filter : filters)
+            included = included || name.contains (filter);
+
+        if (included)
+            csdFiles.add (csdFile);
+    }
+
+    //widgets and timers still expect a message manager, even with no editor
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    if (parsePasses > 0)
+    {
+        runParseBenchmark (csdFiles, parsePasses);
+        return 0;
+    }
+
+    Array<BenchmarkResult> results;
+
+    std::cout << String ("file").paddedRight (' ', 48) << "     sr ksmps  block   load ms compile ms  mean us   p99 us csound us   glue us  chans us   x rt" << std::endl;
+
+    for (auto& csdFile : csdFiles)
+    {
+        const String name = csdFile.getRelativePathFrom (examplesDir).replaceCharacter ('\\', '/');
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto ksmps : ksmpsValues)
+            {
+                const int first = results.size();
+                runFile (csdFile, name, sampleRate, ksmps, blockSizes, duration, results);
+
+                for (int i = first; i < results.size(); i++)
+                    printResult (results.getReference (i));
+            }
+        }
+    }
+
+    const String outputPath = getOption (args, "--output");
+
+    if (outputPath.isNotEmpty())
+    {
+        Array<var> runs;
+
+        for (auto& r : results)
+            runs.add (r.toVar());
+
+        File::getCurrentWorkingDirectory().getChildFile (outputPath).replaceWithText (JSON::toString (var (runs)));
+    }
+
+    const String baselinePath = getOption (args, "--baseline");
+
+    if (baselinePath.isNotEmpty()
+        && compareWithBaseline (results, File::getCurrentWorkingDirectory().getChildFile (baselinePath), tolerance) > 0)
+        return 2;
+
+    return 0;
+}
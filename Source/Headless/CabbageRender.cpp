@@ -0,0 +1,319 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Audio/Plugins/CabbagePluginProcessor.h"
+
+//==============================================================================
+// CabbageRender - renders a .csd instrument to a .wav file without an editor or
+// an audio device. The instrument is loaded through CabbagePluginProcessor, so
+// widgets, parameters and imported plants are set up exactly as they are in a
+// plugin. Rendering runs as fast as the machine allows.
+//
+// Usage:
+// CabbageRender input.csd output.wav [options]
+//      --duration seconds      length of the render, defaults to 10 seconds
+//      --samplerate rate       defaults to 44100
+//      --blocksize samples     host block size, defaults to 512
+//      --bpm tempo             tempo reported by the play head, defaults to 120
+//      --preset file           .snaps or host state XML to apply before rendering
+//      --presetname name       which preset in the file to apply
+//      --automation file       timed parameter and MIDI events, see below
+//
+// Automation files contain one event per line, times are in seconds and lines
+// starting with # are ignored:
+//      1.5     cutoff      1000        set channel 'cutoff' to 1000
+//      2.0     midi        144 60 100  send a MIDI message (status data1 data2)
+// Channel changes are applied at the start of the block they fall in, MIDI
+// messages are placed at their exact sample position.
+//==============================================================================
+
+namespace
+{
+    struct AutomationEvent
+    {
+        double time = 0;
+        String channel;
+        float value = 0;
+        MidiMessage message;
+        bool isMidi = false;
+    };
+
+    struct AutomationEventSorter
+    {
+        static int compareElements (const AutomationEvent& first, const AutomationEvent& second)
+        {
+            return first.time < second.time ? -1 : (first.time > second.time ? 1 : 0);
+        }
+    };
+
+    //==============================================================================
+    class RenderPlayHead : public AudioPlayHead
+    {
+    public:
+        RenderPlayHead (double sampleRate, double bpm) : sampleRate (sampleRate), bpm (bpm) {}
+
+        bool getCurrentPosition (CurrentPositionInfo& result) override
+        {
+            result.resetToDefault();
+            result.bpm = bpm;
+            result.timeInSamples = timeInSamples;
+            result.timeInSeconds = timeInSamples / sampleRate;
+            result.ppqPosition = result.timeInSeconds * bpm / 60.0;
+            result.isPlaying = true;
+            return true;
+        }
+
+        int64 timeInSamples = 0;
+
+    private:
+        double sampleRate, bpm;
+    };
+
+    //==============================================================================
+    bool loadAutomation (const File& file, Array<AutomationEvent>& events)
+    {
+        StringArray lines;
+        lines.addLines (file.loadFileAsString());
+
+        for (int i = 0; i < lines.size(); i++)
+        {
+            const String line = lines[i].trim();
+
+            if (line.isEmpty() || line.startsWith ("#"))
+                continue;
+
+            StringArray tokens;
+            tokens.addTokens (line, " \t", "\"");
+            tokens.removeEmptyStrings();
+
+            AutomationEvent event;
+            event.time = tokens[0].getDoubleValue();
+
+            if (tokens[1] == "midi" && tokens.size() > 2)
+            {
+                uint8 bytes[3] = { (uint8) tokens[2].getIntValue(), (uint8) tokens[3].getIntValue(), (uint8) tokens[4].getIntValue() };
+                const int size = MidiMessage::getMessageLengthFromFirstByte (bytes[0]);
+
+                if (bytes[0] < 0x80 || size > tokens.size() - 2)
+                {
+                    std::cerr << file.getFileName() << ":" << i + 1 << ": invalid MIDI message" << std::endl;
+                    return false;
+                }
+
+                event.isMidi = true;
+                event.message = MidiMessage (bytes, size);
+            }
+            else if (tokens.size() == 3)
+            {
+                event.channel = tokens[1];
+                event.value = tokens[2].getFloatValue();
+            }
+            else
+            {
+                std::cerr << file.getFileName() << ":" << i + 1 << ": expected 'time channel value' or 'time midi status data1 data2'" << std::endl;
+                return false;
+            }
+
+            events.add (event);
+        }
+
+        AutomationEventSorter sorter;
+        events.sort (sorter, true);
+        return true;
+    }
+
+    bool applyPreset (CabbagePluginProcessor& processor, const File& presetFile, const String& presetName)
+    {
+        ScopedPointer<XmlElement> xml (XmlDocument::parse (presetFile));
+
+        if (xml == nullptr)
+            return false;
+
+        if (presetName.isEmpty())
+        {
+            processor.restorePluginState (xml);
+            return true;
+        }
+
+        forEachXmlChildElement (*xml, e)
+        {
+            if (e->getStringAttribute ("PresetName") == presetName)
+            {
+                processor.restorePluginState (e);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //goes through the host parameter if there is one, so the render sees what a host would do
+    void applyChannelValue (CabbagePluginProcessor& processor, const String& channel, float value)
+    {
+        for (auto* p : processor.getParameters())
+        {
+            if (CabbageAudioParameter* param = dynamic_cast<CabbageAudioParameter*> (p))
+            {
+                if (param->channel == channel)
+                {
+                    param->setValueNotifyingHost (param->range.convertTo0to1 (param->range.snapToLegalValue (value)));
+                    return;
+                }
+            }
+        }
+
+        processor.queueControlChannelUpdate (processor.getControlChannelIndex (channel), value);
+    }
+
+    String getOption (const StringArray& args, const String& name, const String& defaultValue = String())
+    {
+        const int index = args.indexOf (name);
+        return (index >= 0 && index < args.size() - 1) ? args[index + 1] : defaultValue;
+    }
+
+    int printUsage()
+    {
+        std::cout << "Usage: CabbageRender input.csd output.wav [--duration seconds] [--samplerate rate]" << std::endl
+                  << "       [--blocksize samples] [--bpm tempo] [--preset file [--presetname name]]" << std::endl
+                  << "       [--automation file]" << std::endl;
+        return 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    StringArray args;
+
+    for (int i = 1; i < argc; i++)
+        args.add (CharPointer_UTF8 (argv[i]));
+
+    if (args.size() < 2)
+        return printUsage();
+
+    const File csdFile = File::getCurrentWorkingDirectory().getChildFile (args[0]);
+    const File wavFile = File::getCurrentWorkingDirectory().getChildFile (args[1]);
+    const double duration = getOption (args, "--duration", "10").getDoubleValue();
+    const double sampleRate = getOption (args, "--samplerate", "44100").getDoubleValue();
+    const int blockSize = getOption (args, "--blocksize", "512").getIntValue();
+    const double bpm = getOption (args, "--bpm", "120").getDoubleValue();
+
+    if (csdFile.existsAsFile() == false || duration <= 0 || sampleRate <= 0 || blockSize <= 0)
+        return printUsage();
+
+    Array<AutomationEvent> events;
+    const String automationPath = getOption (args, "--automation");
+
+    if (automationPath.isNotEmpty()
+        && loadAutomation (File::getCurrentWorkingDirectory().getChildFile (automationPath), events) == false)
+        return 1;
+
+    //widgets and timers still expect a message manager, even with no editor
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const uint32 startTime = Time::getMillisecondCounter();
+    const int numChannels = CsdDocument::forFile (csdFile)->getHeaderInfo ("nchnls");
+    ScopedPointer<CabbagePluginProcessor> processor (new CabbagePluginProcessor (csdFile, numChannels, numChannels));
+
+    processor->setPlayConfigDetails (processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels(), sampleRate, blockSize);
+    processor->setNonRealtime (true);
+    processor->prepareToPlay (sampleRate, blockSize);
+
+    if (processor->csdCompiledWithoutError() == false)
+    {
+        std::cerr << csdFile.getFullPathName() << " failed to compile" << std::endl;
+        return 1;
+    }
+
+    const String presetPath = getOption (args, "--preset");
+
+    if (presetPath.isNotEmpty()
+        && applyPreset (*processor, File::getCurrentWorkingDirectory().getChildFile (presetPath), getOption (args, "--presetname")) == false)
+    {
+        std::cerr << "Could not apply preset from " << presetPath << std::endl;
+        return 1;
+    }
+
+    const int numOutputs = processor->getTotalNumOutputChannels();
+    wavFile.deleteFile();
+    ScopedPointer<FileOutputStream> outStream (wavFile.createOutputStream());
+    WavAudioFormat wavFormat;
+    ScopedPointer<AudioFormatWriter> writer (outStream != nullptr ? wavFormat.createWriterFor (outStream, sampleRate, (unsigned int) numOutputs, 24, StringPairArray(), 0)
+                                                                  : nullptr);
+
+    if (writer == nullptr)
+    {
+        std::cerr << "Could not write to " << wavFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    //the writer owns the stream now
+    outStream.release();
+
+    const uint32 renderStartTime = Time::getMillisecondCounter();
+    RenderPlayHead playHead (sampleRate, bpm);
+    processor->setPlayHead (&playHead);
+
+    AudioBuffer<float> buffer (jmax (processor->getTotalNumInputChannels(), numOutputs), blockSize);
+    MidiBuffer midiBuffer;
+    const int64 totalSamples = (int64) (duration * sampleRate);
+    int nextEvent = 0;
+
+    for (int64 position = 0; position < totalSamples; position += blockSize)
+    {
+        const int numSamples = (int) jmin ((int64) blockSize, totalSamples - position);
+        const double blockEndTime = (position + numSamples) / sampleRate;
+
+        midiBuffer.clear();
+
+        while (nextEvent < events.size() && events.getReference (nextEvent).time < blockEndTime)
+        {
+            const AutomationEvent& event = events.getReference (nextEvent++);
+
+            if (event.isMidi)
+                midiBuffer.addEvent (event.message, jlimit (0, numSamples - 1, (int) (event.time * sampleRate - position)));
+            else
+                applyChannelValue (*processor, event.channel, event.value);
+        }
+
+        buffer.setSize (buffer.getNumChannels(), numSamples, false, false, true);
+        buffer.clear();
+        playHead.timeInSamples = position;
+
+        {
+            const ScopedLock sl (processor->getCallbackLock());
+            processor->processBlock (buffer, midiBuffer);
+        }
+
+        writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+    }
+
+    processor->setPlayHead (nullptr);
+    processor->releaseResources();
+    writer = nullptr;
+
+    const double renderSeconds = jmax (1, (int) (Time::getMillisecondCounter() - renderStartTime)) / 1000.0;
+    std::cout << "Rendered " << duration << " seconds of " << csdFile.getFileName() << " to " << wavFile.getFullPathName() << std::endl
+              << "Load time: " << (renderStartTime - startTime) / 1000.0 << "s, render time: " << renderSeconds
+              << "s (" << duration / renderSeconds << "x real time)" << std::endl;
+
+    processor = nullptr;
+    return 0;
+}
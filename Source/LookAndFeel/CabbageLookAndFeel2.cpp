@@ -1171,19 +1171,31 @@ void CabbageLookAndFeel2::drawTwoValueThumb (Graphics& g, float x, float y, floa
 //if using an SVG..
 void CabbageLookAndFeel2::drawFromSVG (Graphics& g, File svgFile, int x, int y, int newWidth, int newHeight, AffineTransform affine)
 {
-    ScopedPointer<XmlElement> svg (XmlDocument::parse (svgFile.loadFileAsString()));
+    //parsed drawables and rendered images are cached, so repaints don't reparse the file
+    SharedResourcePointer<CabbageSVGCache> svgCache;
+    const Rectangle<float> area (x, y, newWidth, newHeight);
 
-    if (svg == nullptr)
-        jassert (false);
+    if (affine.isIdentity())
+    {
+        const Image image = svgCache->getImage (svgFile, newWidth, newHeight,
+                                                g.getInternalContext().getPhysicalPixelScaleFactor());
 
-    ScopedPointer<Drawable> drawable;
+        if (image.isNull())
+            jassertfalse;
+        else
+            g.drawImage (image, area, RectanglePlacement::stretchToFit);
 
-    if (svg != nullptr)
-    {
-        drawable = Drawable::createFromSVG (*svg);
-        drawable->setTransformToFit (Rectangle<float> (x, y, newWidth, newHeight), RectanglePlacement::stretchToFit);
-        drawable->draw (g, 1.f, affine);
+        return;
     }
+
+    const Drawable* drawable = svgCache->getDrawable (svgFile);
+
+    if (drawable == nullptr)
+        jassertfalse;
+    else if (! area.isEmpty())
+        drawable->draw (g, 1.f, RectanglePlacement (RectanglePlacement::stretchToFit)
+                                    .getTransformToFit (drawable->getDrawableBounds(), area)
+                                    .followedBy (affine));
 }
 
 void CabbageLookAndFeel2::drawAlertBox (Graphics& g,
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "../CabbageCommonHeaders.h"
+#include "CabbageSVGCache.h"
 
 static Drawable* createDrawableFromSVG (const char* data)
 {
@@ -123,6 +124,8 @@ public:
 private:
 
     Font customFont;
+    //keeps the shared SVG cache alive for as long as a look and feel exists
+    SharedResourcePointer<CabbageSVGCache> svgCache;
 
 };
 
@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageSVGCache.h"
+
+//==============================================================================
+CabbageSVGCache::DrawableEntry* CabbageSVGCache::findDrawableEntry (const File& svgFile)
+{
+    const String path = svgFile.getFullPathName();
+    const uint32 now = Time::getMillisecondCounter();
+    DrawableEntry* entry = nullptr;
+
+    for (auto* e : drawables)
+    {
+        if (e->path == path)
+        {
+            entry = e;
+            break;
+        }
+    }
+
+    if (entry != nullptr)
+    {
+        //don't hit the disk on every paint, only every so often
+        if (now - entry->lastFileCheck < fileCheckIntervalMs)
+        {
+            entry->lastUsed = ++useCounter;
+            return entry;
+        }
+
+        entry->lastFileCheck = now;
+
+        if (svgFile.getLastModificationTime() == entry->modificationTime)
+        {
+            entry->lastUsed = ++useCounter;
+            return entry;
+        }
+    }
+    else
+    {
+        if (drawables.size() >= maxNumDrawables)
+        {
+            int oldest = 0;
+
+            for (int i = 1; i < drawables.size(); i++)
+                if (drawables[i]->lastUsed < drawables[oldest]->lastUsed)
+                    oldest = i;
+
+            drawables.remove (oldest);
+        }
+
+        entry = drawables.add (new DrawableEntry());
+        entry->path = path;
+        entry->lastFileCheck = now;
+    }
+
+    //new or changed on disk, (re)parse it
+    entry->modificationTime = svgFile.getLastModificationTime();
+    entry->lastUsed = ++useCounter;
+
+    ScopedPointer<XmlElement> svg (XmlDocument::parse (svgFile.loadFileAsString()));
+    entry->drawable.reset (svg != nullptr ? Drawable::createFromSVG (*svg) : nullptr);
+
+    return entry;
+}
+
+const Drawable* CabbageSVGCache::getDrawable (const File& svgFile)
+{
+    const ScopedLock sl (lock);
+    return findDrawableEntry (svgFile)->drawable.get();
+}
+
+Image CabbageSVGCache::getImage (const File& svgFile, int width, int height, float scale)
+{
+    const ScopedLock sl (lock);
+
+    const int pixelWidth = roundToInt (width * scale);
+    const int pixelHeight = roundToInt (height * scale);
+
+    if (pixelWidth <= 0 || pixelHeight <= 0)
+        return Image();
+
+    DrawableEntry* drawableEntry = findDrawableEntry (svgFile);
+
+    if (drawableEntry->drawable == nullptr)
+        return Image();
+
+    const String path = svgFile.getFullPathName();
+
+    for (int i = 0; i < images.size(); i++)
+    {
+        ImageEntry* e = images[i];
+
+        if (e->path == path && e->width == pixelWidth && e->height == pixelHeight)
+        {
+            if (e->modificationTime == drawableEntry->modificationTime)
+            {
+                e->lastUsed = ++useCounter;
+                return e->image;
+            }
+
+            //stale, the file has changed since this was rendered
+            imageBytes -= (int64) e->width * e->height * 4;
+            images.remove (i);
+            break;
+        }
+    }
+
+    const int64 bytesNeeded = (int64) pixelWidth * pixelHeight * 4;
+
+    Image image (Image::ARGB, pixelWidth, pixelHeight, true);
+    {
+        Graphics g (image);
+        const Drawable* drawable = drawableEntry->drawable.get();
+        drawable->draw (g, 1.f, RectanglePlacement (RectanglePlacement::stretchToFit)
+                                    .getTransformToFit (drawable->getDrawableBounds(),
+                                                        Rectangle<float> (0.f, 0.f, (float) pixelWidth, (float) pixelHeight)));
+    }
+
+    //images bigger than the whole budget are handed back without being cached
+    if (bytesNeeded > maxImageBytes)
+        return image;
+
+    evictImages (bytesNeeded);
+
+    ImageEntry* entry = images.add (new ImageEntry());
+    entry->path = path;
+    entry->modificationTime = drawableEntry->modificationTime;
+    entry->width = pixelWidth;
+    entry->height = pixelHeight;
+    entry->lastUsed = ++useCounter;
+    entry->image = image;
+    imageBytes += bytesNeeded;
+
+    return image;
+}
+
+void CabbageSVGCache::evictImages (int64 bytesNeeded)
+{
+    while (images.size() > 0 && imageBytes + bytesNeeded > maxImageBytes)
+    {
+        int oldest = 0;
+
+        for (int i = 1; i < images.size(); i++)
+            if (images[i]->lastUsed < images[oldest]->lastUsed)
+                oldest = i;
+
+        imageBytes -= (int64) images[oldest]->width * images[oldest]->height * 4;
+        images.remove (oldest);
+    }
+}
+
+void CabbageSVGCache::clear()
+{
+    const ScopedLock sl (lock);
+    drawables.clear();
+    images.clear();
+    imageBytes = 0;
+}
@@ -0,0 +1,83 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGESVGCACHE_H_INCLUDED
+#define CABBAGESVGCACHE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Process wide cache of parsed SVG files, shared by every look and feel that skins
+// widgets with SVGs. Drawables are keyed on file path and modification time, so an
+// edited file is picked up again, and rendered images are keyed on file, pixel size
+// and scale factor. Both caches are bounded and evict the least recently used entry.
+// Access it through a SharedResourcePointer<CabbageSVGCache>.
+//==============================================================================
+class CabbageSVGCache
+{
+public:
+    CabbageSVGCache() {}
+    ~CabbageSVGCache() {}
+
+    //returns nullptr if the file can't be parsed. The drawable is owned by the cache
+    //and must not be modified, draw it with an explicit transform instead
+    const Drawable* getDrawable (const File& svgFile);
+
+    //returns a null image if the file can't be parsed
+    Image getImage (const File& svgFile, int width, int height, float scale);
+
+    void clear();
+
+    static const int maxNumDrawables = 256;
+    static const int64 maxImageBytes = 32 * 1024 * 1024;
+    //how often a cached file is checked for changes on disk
+    static const uint32 fileCheckIntervalMs = 1000;
+
+private:
+    struct DrawableEntry
+    {
+        String path;
+        Time modificationTime;
+        uint32 lastFileCheck = 0;
+        uint32 lastUsed = 0;
+        std::unique_ptr<Drawable> drawable;
+    };
+
+    struct ImageEntry
+    {
+        String path;
+        Time modificationTime;
+        int width = 0, height = 0;
+        uint32 lastUsed = 0;
+        Image image;
+    };
+
+    DrawableEntry* findDrawableEntry (const File& svgFile);
+    void evictImages (int64 bytesNeeded);
+
+    CriticalSection lock;
+    OwnedArray<DrawableEntry> drawables;
+    OwnedArray<ImageEntry> images;
+    int64 imageBytes = 0;
+    uint32 useCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageSVGCache)
+};
+
+#endif  // CABBAGESVGCACHE_H_INCLUDED
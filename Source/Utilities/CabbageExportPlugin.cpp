@@ -247,107 +247,38 @@ void PluginExporter::writePluginFileToDisk (File fc, File csdFile, File VSTData,
 //==============================================================================
 int PluginExporter::setUniquePluginId (File binFile, File csdFile, String pluginId, bool isRSRC)
 {
-    size_t file_size;
-    const char* pluginID;
-    
-    if (isRSRC)
-        pluginID = "RORY";
-    else
-        pluginID = "YROR";
-    
-    long loc;
-    std::fstream mFile (binFile.getFullPathName().toUTF8(), ios_base::in | ios_base::out | ios_base::binary);
-    
-    if (mFile.is_open())
+    //each field has a fixed width, replacements are padded with spaces to match. The
+    //manufacturer field is 16 bytes even though its placeholder is only 12
+    Array<BinaryPatch> patches;
+    patches.add (BinaryPatch (isRSRC ? "RORY" : "YROR", pluginId, 4));
+    patches.add (BinaryPatch ("CabbageAudio", JucePlugin_Manufacturer, 16));
+    patches.add (BinaryPatch ("CabbageEffectNam", csdFile.getFileNameWithoutExtension(), 16));
+
+    //map the binary once and patch every placeholder in place in a single pass
+    MemoryMappedFile binary (binFile, MemoryMappedFile::readWrite);
+
+    if (binary.getData() == nullptr)
     {
-        mFile.seekg (0, ios::end);
-        file_size = mFile.tellg();
-        unsigned char* buffer = (unsigned char*)malloc (sizeof (unsigned char) * file_size);
-        
-        //set plugin ID, do this a few times in case the plugin ID appear in more than one place.
-        for (int r = 0; r < 10; r++)
-        {
-            mFile.seekg (0, ios::beg);
-            mFile.read ((char*)&buffer[0], file_size);
-            loc = cabbageFindPluginId (buffer, file_size, pluginID);
-            
-            if (loc < 0)
-            {
-                break;
-            }
-            else
-            {
-                mFile.seekg (loc, ios::beg);
-                mFile.write (pluginId.toUTF8(), 4);
-            }
-        }
-        
-        String manu(JucePlugin_Manufacturer);
-        mFile.seekg (0, ios::end);
-        String manuName;
-        if (manu.length() < 16)
-            for (int y = manu.length(); y < 16; y++)
-                manu.append (String (" "), 1);
-        //set manufacturer do this a few times in case the plugin ID appear in more than one place.
-        for (int r = 0; r < 10; r++)
-        {
-            mFile.seekg (0, ios::beg);
-            mFile.read ((char*)&buffer[0], file_size);
-            loc = cabbageFindPluginId (buffer, file_size, "CabbageAudio");
-            
-            if (loc < 0)
-            {
-                break;
-            }
-            else
-            {
-                mFile.seekg (loc, ios::beg);
-                mFile.write (manu.toUTF8(), 16);
-            }
-        }
-        
-        
-        
-        //set plugin name based on .csd file
-        const char* pluginName = "CabbageEffectNam";
-        String plugLibName = csdFile.getFileNameWithoutExtension();
-        
-        if (plugLibName.length() < 16)
-            for (int y = plugLibName.length(); y < 16; y++)
-                plugLibName.append (String (" "), 1);
-        
-        mFile.seekg (0, ios::end);
-        //buffer = (unsigned char*)malloc(sizeof(unsigned char)*file_size);
-        
-        for (int i = 0; i < 5; i++)
+        DBG ("===============================\nError/n=======================================\n" + binFile.getFullPathName()+" File could not be opened");
+        return 0;
+    }
+
+    uint8* const data = static_cast<uint8*> (binary.getData());
+    const int numPatched = patchPlaceholders (data, binary.getSize(), patches, true);
+
+    //verify, nothing should be left to patch unless a replacement is the placeholder itself
+    patchPlaceholders (data, binary.getSize(), patches, false);
+
+    for (const auto& patch : patches)
+    {
+        if (patch.numFound > 0 && ! patch.replacementIsPlaceholder())
         {
-            
-            mFile.seekg (0, ios::beg);
-            mFile.read ((char*)&buffer[0], file_size);
-            
-            
-            loc = cabbageFindPluginId (buffer, file_size, pluginName);
-            
-            if (loc < 0)
-                break;
-            else
-            {
-                mFile.seekg (loc, ios::beg);
-                mFile.write (plugLibName.toUTF8(), 16);
-            }
+            DBG ("===============================\nError/n=======================================\n" + binFile.getFullPathName()+" could not be patched");
+            return 0;
         }
-        
-        loc = cabbageFindPluginId (buffer, file_size, pluginID);
-        
-        free (buffer);
-        
     }
-    else
-        DBG ("===============================\nError/n=======================================\n" + csdFile.getFullPathName()+" File could not be opened");
-    
-    mFile.close();
-    
-    return 1;
+
+    return numPatched;
 }
 //==============================================================================
 // Bundles files with VST
@@ -423,34 +354,68 @@ void PluginExporter::addFilesToPluginBundle (File csdFile, File exportDir)
 
 
 
-long PluginExporter::cabbageFindPluginId (unsigned char* buf, size_t len, const char* s)
+PluginExporter::BinaryPatch::BinaryPatch (const char* textToFind, const String& text, size_t fieldWidth)
+    : placeholder (textToFind), length (strlen (textToFind)), width (jmax (fieldWidth, strlen (textToFind))),
+      replacement (width, false)
+{
+    const char* utf8 = text.toRawUTF8();
+    size_t numBytes = jmin (width, text.getNumBytesAsUTF8());
+
+    //don't cut a multi-byte character in half
+    if (numBytes < text.getNumBytesAsUTF8())
+        while (numBytes > 0 && (utf8[numBytes] & 0xc0) == 0x80)
+            numBytes--;
+
+    replacement.fillWith (' ');
+    replacement.copyFrom (utf8, 0, numBytes);
+}
+
+bool PluginExporter::BinaryPatch::replacementIsPlaceholder() const
 {
-    long i, j;
-    size_t slen = strlen (s);
-    size_t imax = len - slen - 1;
-    long ret = -1;
-    int match;
+    return memcmp (replacement.getData(), placeholder, length) == 0;
+}
 
-    for (i = 0; i < imax; i++)
+//==============================================================================
+// Looks for all placeholders in one pass. Only bytes that start a placeholder are
+// compared further. Sets numFound on each patch and returns the total number found,
+// overwriting their fields with the replacements if applyPatches is true.
+//==============================================================================
+int PluginExporter::patchPlaceholders (uint8* data, size_t numBytes, Array<BinaryPatch>& patches, bool applyPatches)
+{
+    bool startsPlaceholder[256] = {};
+
+    for (auto& patch : patches)
     {
-        match = 1;
+        startsPlaceholder[(uint8) patch.placeholder[0]] = true;
+        patch.numFound = 0;
+    }
 
-        for (j = 0; j < slen; j++)
+    int numFound = 0;
+    size_t i = 0;
+
+    while (i < numBytes)
+    {
+        size_t matchLength = 0;
+
+        if (startsPlaceholder[data[i]])
         {
-            if (buf[i + j] != s[j])
+            for (auto& patch : patches)
             {
-                match = 0;
-                break;
+                if (patch.width <= numBytes - i && memcmp (data + i, patch.placeholder, patch.length) == 0)
+                {
+                    if (applyPatches)
+                        memcpy (data + i, patch.replacement.getData(), patch.width);
+
+                    patch.numFound++;
+                    numFound++;
+                    matchLength = applyPatches ? patch.width : patch.length;
+                    break;
+                }
             }
         }
 
-        if (match)
-        {
-            ret = i;
-            break;
-        }
+        i += jmax ((size_t) 1, matchLength);
     }
 
-    //return position of plugin ID
-    return ret;
+    return numFound;
 }
@@ -29,10 +29,25 @@ class PluginExporter
 {
 CabbageIDELookAndFeel lookAndFeel;
 
+    //a placeholder string in the plugin binary and the fixed width field written over it
+    struct BinaryPatch
+    {
+        BinaryPatch() {}
+        BinaryPatch (const char* textToFind, const String& text, size_t fieldWidth);
+        bool replacementIsPlaceholder() const;
+
+        const char* placeholder = "";
+        size_t length = 0;
+        size_t width = 0;
+        MemoryBlock replacement;
+        int numFound = 0;
+    };
+
+    static int patchPlaceholders (uint8* data, size_t numBytes, Array<BinaryPatch>& patches, bool applyPatches);
+
 public:
     PluginExporter():lookAndFeel() {}
 
-    long cabbageFindPluginId (unsigned char* buf, size_t len, const char* s);
     int setUniquePluginId (File binFile, File csdFile, String pluginId, bool isRSRC=false);
     void writePluginFileToDisk (File fc, File csdFile, File VSTData, String fileExtension, String pluginId, String type, bool encrypt = false);
     void addFilesToPluginBundle (File csdFile, File exportDir);
@@ -0,0 +1,256 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CsdDocument.h"
+
+static const char* const openingTags[] = { "<Cabbage>", "<CsOptions>", "<CsInstruments>", "<CsScore>" };
+static const char* const closingTags[] = { "</Cabbage>", "</CsOptions>", "</CsInstruments>", "</CsScore>" };
+
+//removes /* */ comments from a line, carrying an unterminated one over to the next
+static String stripBlockComments (const String& line, bool& inBlockComment)
+{
+    String code;
+
+    for (int pos = 0; pos < line.length();)
+    {
+        if (inBlockComment)
+        {
+            const int end = line.indexOf (pos, "*/");
+
+            if (end < 0)
+                break;
+
+            inBlockComment = false;
+            pos = end + 2;
+        }
+        else
+        {
+            const int start = line.indexOf (pos, "/*");
+
+            if (start < 0)
+            {
+                code += line.substring (pos);
+                break;
+            }
+
+            code += line.substring (pos, start);
+            inBlockComment = true;
+            pos = start + 2;
+        }
+    }
+
+    return code;
+}
+
+//==============================================================================
+CsdDocument::CsdDocument (const String& csdText)
+    : text (csdText)
+{
+    lines.addLines (text);
+
+    int sectionStarts[numSections] = { -1, -1, -1, -1 };
+    bool cabbageOpened = false, cabbageClosed = false, inBlockComment = false;
+
+    for (int i = 0; i < lines.size(); i++)
+    {
+        const String& line = lines.getReference (i);
+
+        if (line.containsChar ('<'))
+        {
+            for (int s = 0; s < numSections; s++)
+            {
+                if (line.contains (openingTags[s]))
+                    sectionStarts[s] = i + 1;
+
+                if (line.contains (closingTags[s]) && sectionStarts[s] >= 0)
+                    sections[s] = Range<int> (sectionStarts[s], i);
+            }
+
+            cabbageOpened = cabbageOpened || line.contains (openingTags[cabbageSection]);
+            cabbageClosed = cabbageClosed || line.contains (closingTags[cabbageSection]);
+            hasCsoundTags = hasCsoundTags || line.contains ("<Csound") || line.contains ("</Csound");
+        }
+
+        const String trimmedLine = line.trimStart();
+
+        if (formLineIndex < 0 && ! cabbageClosed && trimmedLine.startsWith ("form")
+            && ! CharacterFunctions::isLetterOrDigit (trimmedLine[4]))
+            formLineIndex = i;
+
+        String macroName, macroText;
+
+        if (parseMacroDefinition (line, macroName, macroText))
+            macros.set (macroName, macroText);
+
+        if (trimmedLine.startsWith ("#include"))
+            includeFiles.add (trimmedLine.substring (8).upToFirstOccurrenceOf (";", false, false).trim().unquoted());
+
+        //header statements come from the orchestra, with any comments removed
+        const bool inInstruments = isPositiveAndNotGreaterThan (sectionStarts[instrumentsSection], i)
+                                   && sections[instrumentsSection].getEnd() <= 0;
+
+        if (inInstruments && (inBlockComment || line.contains ("/*") || line.containsChar ('=')))
+        {
+            const String code = stripBlockComments (line, inBlockComment).upToFirstOccurrenceOf (";", false, false);
+            const String name = code.upToFirstOccurrenceOf ("=", false, false).trim();
+
+            if (code.containsChar ('=') && name.isNotEmpty() && name.containsOnly ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_")
+                && ! headerInfo.contains (name))
+                headerInfo.set (name, code.fromFirstOccurrenceOf ("=", false, false).trim().getIntValue());
+        }
+    }
+
+    hasCabbageTags = cabbageOpened && cabbageClosed;
+}
+
+double CsdDocument::getLastScoreEventTime() const
+{
+    return getLastEventTime (lines, sections[scoreSection]);
+}
+
+double CsdDocument::getLastEventTime (const String& scoreText)
+{
+    StringArray scoreLines;
+    scoreLines.addLines (scoreText);
+    return getLastEventTime (scoreLines, Range<int> (0, scoreLines.size()));
+}
+
+double CsdDocument::getLastEventTime (const StringArray& scoreLines, Range<int> range)
+{
+    const double unknownTime = std::numeric_limits<double>::max();
+    double lastTime = 0;
+    bool inBlockComment = false;
+
+    for (int i = range.getStart(); i < range.getEnd(); i++)
+    {
+        const String statement = stripBlockComments (scoreLines[i], inBlockComment).upToFirstOccurrenceOf (";", false, false)
+                                                                              .upToFirstOccurrenceOf ("//", false, false).trim();
+
+        if (statement.isEmpty())
+            continue;
+
+        if (statement[0] == 'e')
+            break;
+
+        if (statement[0] != 'i' && statement[0] != 'f')
+            return unknownTime;
+
+        StringArray pFields;
+        pFields.addTokens (statement.substring (1), " \t", "\"");
+        pFields.removeEmptyStrings();
+
+        //f0 only keeps Csound running, it doesn't schedule anything
+        if (statement[0] == 'f' && pFields[0].getIntValue() == 0)
+            continue;
+
+        //a carried start time is the same as the previous statement's
+        if (pFields[1] == ".")
+            continue;
+
+        if (pFields[1].isEmpty() || ! pFields[1].containsOnly ("0123456789.eE-"))
+            return unknownTime;
+
+        lastTime = jmax (lastTime, pFields[1].getDoubleValue());
+    }
+
+    return lastTime;
+}
+
+CsdDocument::Ptr CsdDocument::forFile (const File& csdFile)
+{
+    struct CachedDocument
+    {
+        File file;
+        Time modificationTime;
+        int64 size;
+        Ptr document;
+    };
+
+    static CriticalSection cacheLock;
+    static Array<CachedDocument> cache;
+    const int maxCachedDocuments = 32;
+
+#if defined(Cabbage_IDE_Build)
+    //files edited in the IDE can change twice within the resolution of their timestamps
+    return new CsdDocument (csdFile.loadFileAsString());
+#endif
+
+    if (csdFile.existsAsFile() == false)
+        return new CsdDocument (String());
+
+    const Time modificationTime = csdFile.getLastModificationTime();
+    const int64 size = csdFile.getSize();
+
+    {
+        const ScopedLock sl (cacheLock);
+
+        for (int i = 0; i < cache.size(); i++)
+        {
+            if (cache.getReference (i).file == csdFile)
+            {
+                if (cache.getReference (i).modificationTime == modificationTime && cache.getReference (i).size == size)
+                    return cache.getReference (i).document;
+
+                cache.remove (i);
+                break;
+            }
+        }
+    }
+
+    //read outside the lock so loading one file never holds up another
+    CachedDocument entry = { csdFile, modificationTime, size, new CsdDocument (csdFile.loadFileAsString()) };
+
+    const ScopedLock sl (cacheLock);
+
+    if (cache.size() >= maxCachedDocuments)
+        cache.remove (0);
+
+    cache.add (entry);
+    return entry.document;
+}
+
+int CsdDocument::getHeaderInfo (const String& headerName) const
+{
+    if (headerInfo.contains (headerName))
+        return headerInfo[headerName];
+
+    return headerName == "nchnls" ? 2 : -1;
+}
+
+bool CsdDocument::parseMacroDefinition (const String& line, String& name, String& macroText)
+{
+    if (line.containsIgnoreCase ("define") == false)
+        return false;
+
+    const String csdLine = line.replace ("\n", " ");
+    StringArray tokens;
+    tokens.addTokens (csdLine, ", ");
+
+    if (tokens[0].containsIgnoreCase ("define") == false)
+        return false;
+
+    tokens.removeEmptyStrings();
+
+    if (tokens.size() < 2)
+        return false;
+
+    name = tokens[1];
+    macroText = csdLine.substring (csdLine.indexOf (tokens[1]) + tokens[1].length()) + " ";
+    return true;
+}
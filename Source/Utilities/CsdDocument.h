@@ -0,0 +1,99 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CSDDOCUMENT_H_INCLUDED
+#define CSDDOCUMENT_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// A .csd file read and indexed in a single pass: its lines, where each section starts and
+// ends, the orchestra header fields, Cabbage macros, the form line and any #include files.
+// Documents are immutable once built, so forFile() can hand the same one to every instance
+// and thread that loads a file, reading it again only when it changes on disk. IDE builds
+// always read the file, as it may have been saved moments before.
+//==============================================================================
+class CsdDocument : public ReferenceCountedObject
+{
+public:
+    typedef ReferenceCountedObjectPtr<CsdDocument> Ptr;
+
+    enum Section
+    {
+        cabbageSection = 0,
+        optionsSection,
+        instrumentsSection,
+        scoreSection,
+        numSections
+    };
+
+    explicit CsdDocument (const String& csdText);
+
+    //returns a shared document for the file, re-reading it only if it has been modified
+    static Ptr forFile (const File& csdFile);
+
+    const String& getText() const noexcept                  { return text; }
+    const StringArray& getLines() const noexcept            { return lines; }
+
+    //the lines between a section's opening and closing tags, empty if it has none
+    Range<int> getSection (Section section) const noexcept  { return sections[section]; }
+
+    bool hasCabbageSection() const noexcept                 { return hasCabbageTags; }
+    bool hasCsoundSection() const noexcept                  { return hasCsoundTags; }
+
+    //integer value of an orchestra header statement such as sr, ksmps or nchnls, when it
+    //isn't set nchnls defaults to 2 and everything else to -1
+    int getHeaderInfo (const String& headerName) const;
+
+    //index of the line that holds the form widget, -1 if there isn't one
+    int getFormLineIndex() const noexcept                   { return formLineIndex; }
+
+    //Cabbage macro names, without the leading $, mapped to their text
+    const StringPairArray& getMacros() const noexcept       { return macros; }
+
+    //files pulled into the orchestra or score with #include, as written in the file
+    const StringArray& getIncludeFiles() const noexcept     { return includeFiles; }
+
+    //start time in seconds of the latest i or f statement in the score, or the largest possible
+    //time when that can't be read off the page, e.g, with sections, tempo, loops or macros
+    double getLastScoreEventTime() const;
+
+    //the same for score text sent while Csound runs, i.e, "i1 2 1", where the start times
+    //are relative to when the text is sent
+    static double getLastEventTime (const String& scoreText);
+
+    //splits a Cabbage #define line into its name and text, returns false for any other line
+    static bool parseMacroDefinition (const String& line, String& name, String& macroText);
+
+private:
+    String text;
+    StringArray lines;
+    Range<int> sections[numSections];
+    bool hasCabbageTags = false, hasCsoundTags = false;
+    HashMap<String, int> headerInfo;
+    int formLineIndex = -1;
+    StringPairArray macros;
+    StringArray includeFiles;
+
+    static double getLastEventTime (const StringArray& scoreLines, Range<int> range);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CsdDocument)
+};
+
+#endif  // CSDDOCUMENT_H_INCLUDED
@@ -102,7 +102,7 @@ void CabbageButton::valueTreePropertyChanged(ValueTree& valueTree, const Identif
 	else
 	{
 		setLookAndFeelColours(valueTree);
-		handleCommonUpdates(this, valueTree);      //handle comon updates such as bounds, alpha, rotation, visible, etc
+		handleCommonUpdates(this, valueTree, false, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
 		populateTextArrays(valueTree);
 		//const String newText = CabbageWidgetData::getStringProp(valueTree, CabbageIdentifierIds::text);
 		//if(newText != getTextArray()[getValue()])
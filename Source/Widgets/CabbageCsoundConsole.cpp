@@ -71,5 +71,5 @@ void CabbageCsoundConsole::valueTreePropertyChanged (ValueTree& valueTree, const
     setColour (TextEditor::backgroundColourId, Colour::fromString (CabbageWidgetData::getStringProp (valueTree, CabbageIdentifierIds::colour)));
     lookAndFeelChanged();
     repaint();
-    handleCommonUpdates (this, valueTree);      //handle comon updates such as bounds, alpha, rotation, visible, etc
+    handleCommonUpdates (this, valueTree, false, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
 }
\ No newline at end of file
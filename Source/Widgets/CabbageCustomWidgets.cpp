@@ -41,7 +41,7 @@ void DemoCabbageWidget::valueTreePropertyChanged (ValueTree& valueTree, const Id
 
 
 
-        handleCommonUpdates (this, valueTree);      //handle common updates such as bounds, alpha, rotation, visible, etc
+        handleCommonUpdates (this, valueTree, false, prop);      //handle common updates such as bounds, alpha, rotation, visible, etc
     }
 }
 //add any new custom widgets here to avoid having to edit makefiles and projects
@@ -49,9 +49,9 @@ void DemoCabbageWidget::valueTreePropertyChanged (ValueTree& valueTree, const Id
 CabbageMeter::CabbageMeter (ValueTree wData, CabbagePluginEditor* _owner):
     widgetData (wData),
     owner (_owner),
-    overlayRect (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::overlaycolour).toString())),
     isVertical (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::orientation).toString() == "vertical" ? true : false),
     outlineColour (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::outlinecolour).toString())),
+    overlayColour (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::overlaycolour).toString())),
     outlineThickness (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::outlinethickness)),
     corners (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::corners))
 {
@@ -64,51 +64,122 @@ CabbageMeter::CabbageMeter (ValueTree wData, CabbagePluginEditor* _owner):
         gradientColours.add (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::metercolour)[i].toString()));
     }
 
-    if (isVertical)
-    {
-        ColourGradient vGradient (gradientColours[0], 0.f, 0.f, gradientColours[gradientColours.size() - 1], getWidth(), getHeight(), false);
-
-        for (int i = 1; i < gradientColours.size() - 1; i++)
-            vGradient.addColour ((float)i / (float)gradientColours.size(), gradientColours[i]);
-
-        colourGradient = vGradient;
-    }
-    else
-    {
-        ColourGradient hGradient (gradientColours[0], 0.f, getHeight(), gradientColours[gradientColours.size() - 1], getWidth(), getHeight(), false);
-
-        for (int i = 1; i < gradientColours.size() - 1; i++)
-            hGradient.addColour ((float)i / (float)gradientColours.size(), gradientColours[i]);
-
-        colourGradient = hGradient;
-    }
-
-    addAndMakeVisible (overlayRect);
+    setLevel (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::value));
+    updateMeterSource (wData);
+}
 
+CabbageMeter::~CabbageMeter()
+{
+    releaseMeterSource();
 }
 
 void CabbageMeter::resized()
 {
-    overlayRect.setBounds (0, 0, getWidth(), getHeight());
-    setValue (widgetData);
+    updateMeterImage();
 }
 
-void CabbageMeter::paint (Graphics& g)
+//renders the outline and gradient at the current size, paint() only has to blit it
+void CabbageMeter::updateMeterImage()
 {
+    if (getWidth() <= 0 || getHeight() <= 0 || gradientColours.size() == 0)
+    {
+        meterImage = Image();
+        return;
+    }
+
+    ColourGradient colourGradient (gradientColours[0], 0.f, isVertical ? 0.f : getHeight(),
+                                   gradientColours[gradientColours.size() - 1], getWidth(), getHeight(), false);
+
+    for (int i = 1; i < gradientColours.size() - 1; i++)
+        colourGradient.addColour ((float)i / (float)gradientColours.size(), gradientColours[i]);
+
+    meterImage = Image (Image::ARGB, getWidth(), getHeight(), true);
+    Graphics g (meterImage);
     g.setColour (outlineColour);
     g.fillRoundedRectangle (0, 0, getWidth(), getHeight(), corners);
     g.setGradientFill (colourGradient);
     g.fillRoundedRectangle (outlineThickness, outlineThickness, getWidth() - outlineThickness * 2, getHeight() - outlineThickness * 2, corners);
 }
 
-void CabbageMeter::setValue (ValueTree& valueTree)
+void CabbageMeter::paint (Graphics& g)
 {
-    const float val = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::value);
+    if (meterImage.isNull())
+        updateMeterImage();
+
+    g.drawImageAt (meterImage, 0, 0);
+
+    g.setColour (overlayColour);
 
     if (isVertical)
-        overlayRect.setBounds (outlineThickness, outlineThickness, getWidth() - outlineThickness * 2, (getHeight() * (1.f - val)) - outlineThickness * 2);
+        g.fillRect (outlineThickness, outlineThickness, getWidth() - outlineThickness * 2, (getHeight() * (1.f - level)) - outlineThickness * 2);
     else
-        overlayRect.setBounds (outlineThickness + getWidth() * (val), outlineThickness, getWidth() - getWidth() * (val) - outlineThickness * 2, getHeight() - outlineThickness * 2);
+        g.fillRect (outlineThickness + getWidth() * level, outlineThickness, getWidth() - getWidth() * level - outlineThickness * 2, getHeight() - outlineThickness * 2);
+}
+
+void CabbageMeter::setLevel (float newLevel)
+{
+    newLevel = jlimit (0.f, 1.f, newLevel);
+
+    if (newLevel != level)
+    {
+        level = newLevel;
+        repaint();
+    }
+}
+
+void CabbageMeter::setValue (ValueTree& valueTree)
+{
+    //a bound meter takes its level from the processor, not from chnset
+    if (meterLevels == nullptr)
+        setLevel (CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::value));
+}
+
+//metersource("output:1" [, "peak"|"rms"|"truepeak"])
+void CabbageMeter::updateMeterSource (ValueTree& valueTree)
+{
+    const var source = CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::metersource);
+    const String newSource = source.size() > 0 ? source[0].toString() : String();
+    const String mode = source.size() > 1 ? source[1].toString().toLowerCase() : String ("peak");
+
+    meterMode = mode == "rms" ? rmsMode : mode == "truepeak" ? truePeakMode : peakMode;
+
+    if (newSource == meterSource)
+        return;
+
+    releaseMeterSource();
+
+    if (newSource.isNotEmpty() && owner != nullptr)
+    {
+        meterLevels = owner->addMeterReader (newSource);
+
+        if (meterLevels != nullptr)
+        {
+            meterSource = newSource;
+            startTimerHz (30);
+        }
+    }
+}
+
+void CabbageMeter::releaseMeterSource()
+{
+    stopTimer();
+
+    if (meterLevels != nullptr && owner != nullptr)
+        owner->removeMeterReader (meterSource);
+
+    meterLevels = nullptr;
+    meterSource = String();
+}
+
+//levels are linear gain, the meter shows the top 60dB
+void CabbageMeter::timerCallback()
+{
+    const float gain = meterMode == rmsMode ? meterLevels->rms.get()
+                       : meterMode == truePeakMode ? meterLevels->truePeak.get()
+                       : meterLevels->peak.get();
+
+    const float dB = Decibels::gainToDecibels (gain, -60.f);
+    setLevel (std::round (jmap (dB, -60.f, 0.f, 0.f, 1.f) * 256.f) / 256.f);
 }
 
 void CabbageMeter::valueTreePropertyChanged (ValueTree& valueTree, const Identifier& prop)
@@ -117,9 +188,18 @@ void CabbageMeter::valueTreePropertyChanged (ValueTree& valueTree, const Identif
     {
         setValue (valueTree);
     }
+    else if (prop == CabbageIdentifierIds::metersource)
+    {
+        updateMeterSource (valueTree);
+    }
     else
     {
-        overlayRect.colour = Colour::fromString (CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::overlaycolour).toString());
-        handleCommonUpdates (this, valueTree);      //handle common updates such as bounds, alpha, rotation, visible, etc
+        if (prop == CabbageIdentifierIds::overlaycolour)
+        {
+            overlayColour = Colour::fromString (CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::overlaycolour).toString());
+            repaint();
+        }
+
+        handleCommonUpdates (this, valueTree, false, prop);      //handle common updates such as bounds, alpha, rotation, visible, etc
     }
 }
@@ -22,6 +22,7 @@
 
 #include "../CabbageCommonHeaders.h"
 #include "CabbageWidgetBase.h"
+#include "../Audio/Plugins/CabbageMeterEngine.h"
 
 class CabbagePluginEditor;
 
@@ -48,30 +49,37 @@ public:
 };
 
 //add any new class declarations below this line..
-class CabbageMeter : public Component, public ValueTree::Listener, public CabbageWidgetBase
+//==============================================================================
+// The gradient and outline are rendered once into meterImage whenever the size
+// or colours change, so a repaint is a single image blit plus one overlay
+// rectangle. With metersource() the meter is bound to a bus channel in the
+// processor's CabbageMeterEngine and polls its levels on a timer instead of
+// waiting for chnset values to arrive through the ValueTree.
+class CabbageMeter : public Component, public ValueTree::Listener, public CabbageWidgetBase, private Timer
 {
     CabbagePluginEditor* owner;
     float level = 0;
     Array<Colour> gradientColours;
-    ColourGradient colourGradient;
-    Colour outlineColour;
+    Colour outlineColour, overlayColour;
     float outlineThickness = 1;
     int corners = 2;
     bool isVertical = true;
-
-    class Overlay : public Component
-    {
-    public:
-        Colour colour;
-        Overlay (Colour colour): Component(), colour (colour) {}
-        void paint (Graphics& g) {    g.fillAll (colour);  };
-    };
-
-    Overlay overlayRect;
+    Image meterImage;
+
+    enum MeterMode { peakMode, rmsMode, truePeakMode };
+    String meterSource;
+    CabbageMeterEngine::Levels* meterLevels = nullptr;
+    MeterMode meterMode = peakMode;
+
+    void updateMeterImage();
+    void updateMeterSource (ValueTree& valueTree);
+    void releaseMeterSource();
+    void setLevel (float newLevel);
+    void timerCallback() override;
 public:
 
     CabbageMeter (ValueTree wData, CabbagePluginEditor* _owner);
-    ~CabbageMeter() {};
+    ~CabbageMeter();
 
     void paint (Graphics& g)  override;
     void resized()  override;
@@ -73,6 +73,44 @@ void CabbageGenTable::initialiseGenTable (ValueTree wData)
 
 
     tables = CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablenumber);
+    addCsoundTables (wData);
+
+    tableColours = CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour);
+    configureTableSizes (wData);
+
+    if (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::startpos) > -1 && CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::endpos) > 0)
+        table.setRange (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::startpos), CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::endpos));
+
+
+    //set grid colour and background colours for all tables
+    if (fileTable == 0)
+        table.setGridColour (Colour::fromString (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::tablegridcolour)));
+    else
+        table.setGridColour (Colours::transparentBlack);
+
+    table.setBackgroundColour (Colour::fromString (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::tablebackgroundcolour)));
+    table.setFill (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::fill));
+
+    //set VU gradients based on tablecolours, take only the first three colours.
+    Array<Colour> gradient;
+
+    for (int i = 0; i < CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour).size(); i++)
+    {
+        gradient.add (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour)[i].toString()));
+    }
+
+    table.setVUGradient (gradient);
+
+    if (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::active) != 1)
+        table.toggleEditMode (false);
+}
+
+//===============================================================================
+//adds any of the widget's tables that Csound has and the table manager doesn't, i.e, all
+//of them unless the editor opened while the instance was still being compiled
+bool CabbageGenTable::addCsoundTables (ValueTree wData)
+{
+    bool tablesAdded = false;
 
     for (int y = 0; y < tables.size(); y++)
     {
@@ -80,7 +118,7 @@ void CabbageGenTable::initialiseGenTable (ValueTree wData)
         tableValues.clear();
         tableValues = owner->getTableFloats (tableNumber);
 
-        if (tableNumber > 0 && tableValues.size() > 0)
+        if (tableNumber > 0 && tableValues.size() > 0 && table.getTableFromFtNumber (tableNumber) == nullptr)
         {
             StringArray pFields = owner->getTableStatement (tableNumber);
             int genRoutine = pFields[4].getIntValue();
@@ -93,6 +131,7 @@ void CabbageGenTable::initialiseGenTable (ValueTree wData)
                                          Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour)[numberOfColours - 1].toString()));
 
                 table.addTable (44100, tableCol, (tableValues.size() >= MAX_TABLE_SIZE ? 1 : genRoutine), ampRanges, tableNumber, this);
+                tablesAdded = true;
 
                 if (abs (genRoutine) == 1 || tableValues.size() >= MAX_TABLE_SIZE)
                 {
@@ -124,40 +163,19 @@ void CabbageGenTable::initialiseGenTable (ValueTree wData)
         }
     }
 
-    tableColours = CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour);
+    return tablesAdded;
+}
+
+void CabbageGenTable::configureTableSizes (ValueTree wData)
+{
     var tableConfigArray = CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tableconfig);
 
-    if (fileTable == 1)
+    //a file table always sits in front of the Csound tables
+    if (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::file).isNotEmpty())
         tableConfigArray.insert (0, 0);
 
     table.configTableSizes (tableConfigArray);
     table.bringTableToFront (0);
-
-    if (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::startpos) > -1 && CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::endpos) > 0)
-        table.setRange (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::startpos), CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::endpos));
-
-
-    //set grid colour and background colours for all tables
-    if (fileTable == 0)
-        table.setGridColour (Colour::fromString (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::tablegridcolour)));
-    else
-        table.setGridColour (Colours::transparentBlack);
-
-    table.setBackgroundColour (Colour::fromString (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::tablebackgroundcolour)));
-    table.setFill (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::fill));
-
-    //set VU gradients based on tablecolours, take only the first three colours.
-    Array<Colour> gradient;
-
-    for (int i = 0; i < CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour).size(); i++)
-    {
-        gradient.add (Colour::fromString (CabbageWidgetData::getProperty (wData, CabbageIdentifierIds::tablecolour)[i].toString()));
-    }
-
-    table.setVUGradient (gradient);
-
-    if (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::active) != 1)
-        table.toggleEditMode (false);
 }
 
 //===============================================================================
@@ -171,6 +189,9 @@ void CabbageGenTable::valueTreePropertyChanged (ValueTree& valueTree, const Iden
 {
     if (CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::update) == 1)
     {
+        if (addCsoundTables (valueTree))
+            configureTableSizes (valueTree);
+
         const int numberOfTables = tables.size();
         tableBuffer.clear();
 
@@ -255,7 +276,7 @@ void CabbageGenTable::valueTreePropertyChanged (ValueTree& valueTree, const Iden
             table.setTableColours (tableColours);
         }
 
-        handleCommonUpdates (this, valueTree);      //handle comon updates such as bounds, alpha, rotation, visible, etc
+        handleCommonUpdates (this, valueTree, false, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
     }
 
 }
\ No newline at end of file
@@ -57,6 +57,8 @@ public:
     void valueTreeChildOrderChanged (ValueTree&, int, int) override {}
     void valueTreeParentChanged (ValueTree&) override {};
     void initialiseGenTable (ValueTree widgetData);
+    bool addCsoundTables (ValueTree widgetData);
+    void configureTableSizes (ValueTree widgetData);
     void changeListenerCallback (ChangeBroadcaster* source) override;
 
 
@@ -73,7 +73,7 @@ void CabbageKeyboardDisplay::valueTreePropertyChanged(ValueTree& valueTree, cons
 
     
 	updateColours(valueTree);
-	handleCommonUpdates(this, valueTree);      //handle comon updates such as bounds, alpha, rotation, visible, etc
+	handleCommonUpdates(this, valueTree, false, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
     
     colourPressedNotes(valueTree);
 
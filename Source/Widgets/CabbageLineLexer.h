@@ -0,0 +1,314 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGELINELEXER_H_INCLUDED
+#define CABBAGELINELEXER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Identifier names are switched on by hash. The case labels are evaluated at compile time,
+// and as two labels with the same value will not compile, every known identifier is
+// guaranteed its own slot. Use CabbageLineLexer::hash() for text that is only known at runtime.
+//==============================================================================
+constexpr unsigned long long int HashStringToInt (const char* str, unsigned long long int hash = 0)
+{
+    return (*str == 0) ? hash : 101 * HashStringToInt (str + 1) + *str;
+}
+
+//==============================================================================
+// Splits a widget line such as rslider bounds(10, 10, 60, 60) channel("gain") range(0, 1, .5)
+// into its identifiers and arguments without copying any of it. Identifiers and arguments
+// are kept as byte ranges of the line's own UTF-8 text, identifiers are hashed in place, and
+// numbers are read straight out of the line. A String is only made when a caller asks for
+// one. The rules are those of the old StringArray based tokeniser: a ')' inside quotes does
+// not end an identifier, quotes are then dropped from arguments, and a trailing comma does
+// not add an empty argument.
+//==============================================================================
+class CabbageLineLexer
+{
+public:
+    CabbageLineLexer (const String& lineOfText)
+        : line (lineOfText),
+          text (line.toRawUTF8()),
+          length ((int) line.getNumBytesAsUTF8())
+    {
+        //nothing after the last closing bracket can be part of an identifier
+        while (length > 0 && text[length - 1] != ')')
+            --length;
+
+        while (position < length && (text[position] == ')' || text[position] == ',' || text[position] == ' '))
+            ++position;
+    }
+
+    //==============================================================================
+    // moves on to the next identifier in the line, returns false when there are no more
+    bool next()
+    {
+        while (position < length)
+        {
+            int end = position;
+
+            while (end < length && text[end] != ')')
+            {
+                if (text[end] == '\"')
+                {
+                    ++end;
+
+                    while (end < length && text[end] != '\"')
+                        ++end;
+                }
+
+                ++end;
+            }
+
+            int start = position;
+            end = jmin (end, length);
+            position = end + 1;
+
+            while (start < end && (CharacterFunctions::isWhitespace (text[start]) || text[start] == ','))
+                ++start;
+
+            while (end > start && CharacterFunctions::isWhitespace (text[end - 1]))
+                --end;
+
+            int openBracket = start;
+
+            while (openBracket < end && text[openBracket] != '(')
+                ++openBracket;
+
+            //text without an opening bracket, or a bracket with no name, isn't an identifier
+            if (openBracket == start || openBracket == end)
+                continue;
+
+            identifierStart = start;
+            identifierEnd = openBracket;
+            hashEnd = identifierEnd;
+            identifierHasSpaces = false;
+
+            for (int i = identifierStart; i < identifierEnd; i++)
+            {
+                identifierHasSpaces = identifierHasSpaces || text[i] == ' ';
+
+                //identifiers such as colour:1 are matched on their name and colon alone
+                if (text[i] == ':' && hashEnd == identifierEnd)
+                    hashEnd = i + 1;
+            }
+
+            parameterStart = openBracket + 1;
+            parameterEnd = end;
+            splitArguments();
+            return true;
+        }
+
+        return false;
+    }
+
+    //==============================================================================
+    // hash of the current identifier, as matched against HashStringToInt() case labels
+    uint64 getHash() const noexcept             { return hash (identifierStart, hashEnd); }
+
+    // the current identifier up to and including any colon, i.e. colour for colour:1
+    Identifier getIdentifier() const
+    {
+        if (identifierHasSpaces)
+            return getText (identifierStart, hashEnd, false).removeCharacters (" ");
+
+        return Identifier (String::CharPointerType (text + identifierStart), String::CharPointerType (text + hashEnd));
+    }
+
+    // the full text of the current identifier, i.e. colour:1
+    String getFullIdentifier() const            { return getText (identifierStart, identifierEnd, false).removeCharacters (" "); }
+
+    // everything between the identifier's brackets, with quotes removed
+    String getParameter() const                 { return getText (parameterStart, parameterEnd, true); }
+
+    //==============================================================================
+    int getNumArgs() const noexcept             { return numArgs; }
+
+    // the argument at this index with quotes removed, or an empty string if there isn't one
+    String getArg (int index) const
+    {
+        if (! isPositiveAndBelow (index, numArgs))
+            return {};
+
+        const Argument& arg = getArgument (index);
+        return getText (arg.start, arg.end, arg.hasQuotes);
+    }
+
+    float getFloat (int index) const
+    {
+        if (! isPositiveAndBelow (index, numArgs))
+            return 0.f;
+
+        const Argument& arg = getArgument (index);
+
+        if (arg.hasQuotes)
+            return getArg (index).getFloatValue();
+
+        String::CharPointerType t (text + arg.start);
+        return (float) CharacterFunctions::readDoubleValue (t);
+    }
+
+    int getInt (int index) const
+    {
+        if (! isPositiveAndBelow (index, numArgs))
+            return 0;
+
+        const Argument& arg = getArgument (index);
+
+        if (arg.hasQuotes)
+            return getArg (index).getIntValue();
+
+        return CharacterFunctions::getIntValue<int> (String::CharPointerType (text + arg.start));
+    }
+
+    // all of the arguments, for the setters that still work on a StringArray
+    StringArray getArgs() const
+    {
+        StringArray args;
+        args.ensureStorageAllocated (numArgs);
+
+        for (int i = 0; i < numArgs; i++)
+            args.add (getArg (i));
+
+        return args;
+    }
+
+    //==============================================================================
+    static uint64 hash (const String& identifier) noexcept
+    {
+        return hash (identifier.toRawUTF8(), 0, (int) identifier.getNumBytesAsUTF8());
+    }
+
+    // the widget type, i.e. the first word of a line, a space inside quotes doesn't end it
+    static String getWidgetType (const String& lineOfText)
+    {
+        String::CharPointerType t (lineOfText.getCharPointer());
+        const String::CharPointerType start (t);
+
+        while (! t.isEmpty() && *t != ' ')
+        {
+            if (*t == '\"')
+            {
+                ++t;
+
+                while (! t.isEmpty() && *t != '\"')
+                    ++t;
+
+                if (t.isEmpty())
+                    break;
+            }
+
+            ++t;
+        }
+
+        return String (start, t).trim();
+    }
+
+private:
+    struct Argument
+    {
+        int start, end;
+        bool hasQuotes;
+    };
+
+    uint64 hash (int start, int end) const noexcept     { return hash (text, start, end); }
+
+    //the same sum HashStringToInt() works out, run from the end of the name back to its start
+    static uint64 hash (const char* chars, int start, int end) noexcept
+    {
+        unsigned long long int result = 0;
+
+        for (int i = end; --i >= start;)
+            if (chars[i] != ' ')
+                result = 101 * result + chars[i];
+
+        return result;
+    }
+
+    String getText (int start, int end, bool removeQuotes) const
+    {
+        if (end <= start)
+            return {};
+
+        String s (String::CharPointerType (text + start), String::CharPointerType (text + end));
+        return removeQuotes ? s.removeCharacters ("\"") : s;
+    }
+
+    const Argument& getArgument (int index) const
+    {
+        return index < numInlineArgs ? inlineArgs[index] : extraArgs.getReference (index - numInlineArgs);
+    }
+
+    void addArgument (int start, int end, bool hasQuotes)
+    {
+        if (numArgs < numInlineArgs)
+            inlineArgs[numArgs] = { start, end, hasQuotes };
+        else
+            extraArgs.add ({ start, end, hasQuotes });
+
+        ++numArgs;
+    }
+
+    void splitArguments()
+    {
+        numArgs = 0;
+        extraArgs.clearQuick();
+
+        int start = parameterStart;
+        bool hasQuotes = false, hasText = false;
+
+        for (int i = parameterStart; i < parameterEnd; i++)
+        {
+            if (text[i] == ',')
+            {
+                addArgument (start, i, hasQuotes);
+                start = i + 1;
+                hasQuotes = hasText = false;
+            }
+            else if (text[i] == '\"')
+                hasQuotes = true;
+            else
+                hasText = true;
+        }
+
+        if (hasText)
+            addArgument (start, parameterEnd, hasQuotes);
+    }
+
+    //==============================================================================
+    const String line;
+    const char* text;
+    int length, position = 0;
+
+    int identifierStart = 0, identifierEnd = 0, hashEnd = 0;
+    int parameterStart = 0, parameterEnd = 0;
+    bool identifierHasSpaces = false;
+
+    //most identifiers take a handful of arguments, only long lists spill over into the array
+    enum { numInlineArgs = 16 };
+    Argument inlineArgs[numInlineArgs];
+    Array<Argument> extraArgs;
+    int numArgs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (CabbageLineLexer)
+};
+
+#endif  // CABBAGELINELEXER_H_INCLUDED
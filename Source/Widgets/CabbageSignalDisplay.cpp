@@ -32,7 +32,6 @@ CabbageSignalDisplay::CabbageSignalDisplay (ValueTree wData, CabbagePluginEditor
       vectorSize (512),
       shouldDrawSonogram (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::displaytype) == "spectrogram" ? true : false),
       displayType (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::displaytype)),
-      spectrogramImage (Image::RGB, 512, 300, true),
       spectroscopeImage (Image::RGB, 512, 300, true),
       freqRangeDisplay (fontColour, backgroundColour),
       freqRange (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::min), CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::max)),
@@ -49,6 +48,7 @@ CabbageSignalDisplay::CabbageSignalDisplay (ValueTree wData, CabbagePluginEditor
     setName (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::name));
     widgetData.addListener (this);              //add listener to valueTree so it gets notified when a widget's property changes
     initialiseCommonAttributes (this, wData);   //initialise common attributes such as bounds, name, rotation, etc..
+    spectrogram.setLogFrequencyScale (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::logscale) == 1);
 
     addAndMakeVisible (freqRangeDisplay);
 
@@ -70,9 +70,15 @@ CabbageSignalDisplay::CabbageSignalDisplay (ValueTree wData, CabbagePluginEditor
         addAndMakeVisible (zoomOutButton);
     }
 
+    updateTapAnalyser();
     startTimer (updateRate);
 }
 
+CabbageSignalDisplay::~CabbageSignalDisplay()
+{
+    releaseTapAnalyser();
+}
+
 //====================================================================================
 void CabbageSignalDisplay::setBins (int min, int max)
 {
@@ -91,6 +97,7 @@ void CabbageSignalDisplay::scrollBarMoved (ScrollBar* scrollBarThatHasMoved, dou
         moveBy = freqRangeDisplay.getWidth() * moveBy;
         freqRangeDisplay.setTopLeftPosition (-moveBy, 0);
         leftPos = -moveBy;
+        signalPathNeedsUpdate = true;
     }
 }
 
@@ -116,6 +123,7 @@ void CabbageSignalDisplay::zoomIn (int factor)
         freqRangeDisplay.setBounds (1, 0, getWidth() * (zoomLevel + 1), 18);
         freqRangeDisplay.setResolution (10 * zoomLevel + 1);
         scopeWidth = freqRangeDisplay.getWidth();
+        signalPathNeedsUpdate = true;
         showScrollbar (true);
     }
 }
@@ -131,6 +139,7 @@ void CabbageSignalDisplay::zoomOut (int factor)
         freqRangeDisplay.setBounds (0, 0, getWidth()*jmax (1, zoomLevel + 1), 18);
         freqRangeDisplay.setResolution (jmax (10, 10 * zoomLevel + 1));
         scopeWidth = freqRangeDisplay.getWidth();
+        signalPathNeedsUpdate = true;
 
         if (zoomLevel < 1)
             showScrollbar (false);
@@ -159,118 +168,171 @@ void CabbageSignalDisplay::showScrollbar (bool show)
 //====================================================================================
 void CabbageSignalDisplay::drawSonogram()
 {
-    const int rightHandEdge = spectrogramImage.getWidth() - 2;
-    const int imageHeight = spectrogramImage.getHeight();
-
-    spectrogramImage.moveImageSection (0, 0, 1, 0, rightHandEdge, imageHeight);
-
-    Graphics g (spectrogramImage);
-    Range<float> maxLevel = FloatVectorOperations::findMinAndMax (signalFloatArray.getRawDataPointer(), signalFloatArray.size());
-
-    for (int y = 0; y < imageHeight; y++)
-    {
-        const int index = jmap (y, 0, imageHeight, 0, vectorSize);
-        const float level = jmap (signalFloatArray[index], 0.0f, jmax (maxLevel.getEnd(), signalFloatArray[index] + 0.1f), 0.0f, 1.0f);
-        g.setColour (Colour::fromHSV (level, 1.0f, level, 1.0f));
-        g.drawHorizontalLine (imageHeight - y, rightHandEdge, rightHandEdge + 2);
-    }
+    spectrogram.addFrame (signalFloatArray.getRawDataPointer(), jmin (vectorSize, signalFloatArray.size()));
 }
 
 //====================================================================================
-void CabbageSignalDisplay::drawSpectroscope (Graphics& g)
+void CabbageSignalDisplay::updateSpectroscopePath()
 {
-    g.fillAll (backgroundColour);
+    //one filled column per pixel showing the loudest bin that lands on it
+    const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
+    const float height = getHeight() - offset;
+    const int numColumns = getWidth();
+
+    columnMax.resize (numColumns);
+    FloatVectorOperations::fill (columnMax.getRawDataPointer(), 0.f, numColumns);
 
     for (int i = 0; i < vectorSize; i++)
     {
         const int position = jmap (i, 0, vectorSize, leftPos, scopeWidth);
-        const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-        const int height = getHeight() - offset;
-        const int amp = (signalFloatArray[i] * 3 * height);
-        g.setColour (colour);
-        g.drawVerticalLine (position, height - amp, height);
+
+        if (isPositiveAndBelow (position, numColumns))
+            columnMax.getReference (position) = jmax (columnMax.getUnchecked (position), signalFloatArray.getUnchecked (i));
+    }
+
+    for (int x = 0; x < numColumns; x++)
+    {
+        const float amp = jmin (columnMax.getUnchecked (x) * 3 * height, height);
+
+        if (amp > 0)
+            signalPath.addRectangle ((float) x, height - amp, 1.f, amp);
     }
 }
 
 //====================================================================================
-void CabbageSignalDisplay::drawWaveform (Graphics& g)
+void CabbageSignalDisplay::updateWaveformPath()
 {
-    g.fillAll (backgroundColour);
     const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-    const int height = getHeight() - offset;
-    int prevXPos = 0;
-    int prevYPos = jmap (signalFloatArray[0]*-1.f, -1.f, 1.f, 0.f, 1.f) * height;
+    const float height = getHeight() - offset;
+    const int numColumns = getWidth();
+
+    signalPath.startNewSubPath (0.f, jmap (signalFloatArray[0]*-1.f, -1.f, 1.f, 0.f, 1.f) * height);
+
+    //with no more samples than pixels every sample gets a point of its own
+    if (vectorSize <= scopeWidth - leftPos)
+    {
+        for (int i = 0; i < vectorSize; i++)
+            signalPath.lineTo (jmap ((float) i, 0.f, (float) vectorSize, (float) leftPos, (float) scopeWidth),
+                               jmap (signalFloatArray.getUnchecked (i)*-1.f, -1.f, 1.f, 0.f, 1.f) * height);
+
+        return;
+    }
+
+    //otherwise each pixel column is reduced to the min and max of the samples it covers
+    columnMin.resize (numColumns);
+    columnMax.resize (numColumns);
+    FloatVectorOperations::fill (columnMin.getRawDataPointer(), 1.f, numColumns);
+    FloatVectorOperations::fill (columnMax.getRawDataPointer(), -1.f, numColumns);
 
     for (int i = 0; i < vectorSize; i++)
     {
         const int position = jmap (i, 0, vectorSize, leftPos, scopeWidth);
-        const int amp = jmap (signalFloatArray[i]*-1.f, -1.f, 1.f, 0.f, 1.f) * height;
-        g.setColour (colour);
-        g.drawLine (prevXPos, prevYPos, position, amp, lineThickness);
-        prevXPos = position;
-        prevYPos = amp;
+
+        if (isPositiveAndBelow (position, numColumns))
+        {
+            const float sample = jlimit (-1.f, 1.f, signalFloatArray.getUnchecked (i));
+            columnMin.getReference (position) = jmin (columnMin.getUnchecked (position), sample);
+            columnMax.getReference (position) = jmax (columnMax.getUnchecked (position), sample);
+        }
+    }
+
+    for (int x = 0; x < numColumns; x++)
+    {
+        if (columnMin.getUnchecked (x) <= columnMax.getUnchecked (x))
+        {
+            signalPath.lineTo ((float) x, jmap (columnMax.getUnchecked (x)*-1.f, -1.f, 1.f, 0.f, 1.f) * height);
+            signalPath.lineTo ((float) x, jmap (columnMin.getUnchecked (x)*-1.f, -1.f, 1.f, 0.f, 1.f) * height);
+        }
     }
 }
 
 //====================================================================================
-void CabbageSignalDisplay::drawLissajous (Graphics& g)
+void CabbageSignalDisplay::updateLissajousPath()
 {
-    g.fillAll (backgroundColour);
     const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-    const int height = getHeight() - offset;
-    int prevXPos = jmap (signalFloatArray[0], -1.f, 1.f, (float)leftPos, (float)scopeWidth);;
-    int prevYPos = jmap (signalFloatArray2[1], -1.f, 1.f, 0.f, 1.f) * height;
+    const float height = getHeight() - offset;
+    Point<int> lastPixel (jmap (signalFloatArray[0], -1.f, 1.f, (float)leftPos, (float)scopeWidth),
+                          jmap (signalFloatArray2[1], -1.f, 1.f, 0.f, 1.f) * height);
+
+    signalPath.startNewSubPath (lastPixel.toFloat());
 
+    //points that fall on the same pixel as the one before add nothing to the curve
     for (int i = 0; i < vectorSize; i++)
     {
-        const int position = jmap (signalFloatArray[i], -1.f, 1.f, (float)leftPos, (float)scopeWidth);
-        const int amp = jmap (signalFloatArray2[i], -1.f, 1.f, 0.f, 1.f) * height;
-        g.setColour (colour);
-        g.drawLine (prevXPos, prevYPos, position, amp, lineThickness);
-        prevXPos = position;
-        prevYPos = amp;
+        const Point<float> point (jmap (signalFloatArray.getUnchecked (i), -1.f, 1.f, (float)leftPos, (float)scopeWidth),
+                                  jmap (signalFloatArray2.getUnchecked (i), -1.f, 1.f, 0.f, 1.f) * height);
+
+        if (point.toInt() != lastPixel)
+        {
+            signalPath.lineTo (point);
+            lastPixel = point.toInt();
+        }
     }
 }
 
+//====================================================================================
+void CabbageSignalDisplay::updateSignalPath()
+{
+    signalPath.clear();
+    signalPathNeedsUpdate = false;
+
+    if (vectorSize <= 0)
+        return;
+
+    if (displayType == "spectroscope")
+        updateSpectroscopePath();
+    else if (displayType == "waveform")
+        updateWaveformPath();
+    else if (displayType == "lissajous")
+        updateLissajousPath();
+}
+
 //====================================================================================
 void CabbageSignalDisplay:: paint (Graphics& g)
 {
     if (shouldPaint)
     {
         if (shouldDrawSonogram)
-            g.drawImageWithin (spectrogramImage, 0, 0, getWidth(), getHeight(), RectanglePlacement::stretchToFit);
-        else if (displayType == "spectroscope")
-            drawSpectroscope (g);
-        else if (displayType == "waveform")
-            drawWaveform (g);
-        else if (displayType == "lissajous")
-            drawLissajous (g);
-    }
+        {
+            spectrogram.draw (g, getLocalBounds());
+            return;
+        }
+
+        if (signalPathNeedsUpdate)
+            updateSignalPath();
+
+        g.fillAll (backgroundColour);
+        g.setColour (colour);
 
-    shouldPaint = false;
+        if (displayType == "spectroscope")
+            g.fillPath (signalPath);
+        else
+            g.strokePath (signalPath, PathStrokeType (lineThickness, PathStrokeType::beveled));
+    }
 }
 
 //====================================================================================
 void CabbageSignalDisplay::mouseMove (const MouseEvent& e)
 {
+    const double nyquist = owner->getCsoundSampleRate() / 2;
+
     if (shouldDrawSonogram)
     {
-        const int position = jmap (e.getPosition().getY(), 0, getHeight(), 22050, 0);
+        const int position = spectrogram.getProportionOfSpectrum (e.getPosition().getY() / (double) getHeight()) * nyquist;
         showPopup (String (position) + "Hz.");
     }
     else
     {
-        const int position = jmap (e.getPosition().getX(), 0, scopeWidth, 0, 22050);
+        const int position = jmap (e.getPosition().getX(), 0, scopeWidth, 0, roundToInt (nyquist));
         showPopup (String (position) + "Hz.");
     }
 }
 
 //====================================================================================
-void CabbageSignalDisplay::setSignalFloatArray (Array<float, CriticalSection> _points)
+void CabbageSignalDisplay::signalFrameReceived()
 {
-    signalFloatArray.swapWith (_points);
-
-    if (displayType == "lissajous" || displayType == "waveform")
+    //Csound's display graphs hold twice the samples that are shown, tap frames are shown whole
+    if ((displayType == "lissajous" || displayType == "waveform") && tapAnalyser == nullptr)
         vectorSize = signalFloatArray.size() / 2;
     else
         vectorSize = signalFloatArray.size();
@@ -282,47 +344,129 @@ void CabbageSignalDisplay::setSignalFloatArray (Array<float, CriticalSection> _p
             drawSonogram();
 
         shouldPaint = true;
+        signalPathNeedsUpdate = true;
     }
 }
 
 //====================================================================================
-void CabbageSignalDisplay::setSignalFloatArraysForLissajous (Array<float, CriticalSection> _points1, Array<float, CriticalSection> _points2)
+void CabbageSignalDisplay::lissajousFramesReceived()
 {
-    signalFloatArray.swapWith (_points1);
-    signalFloatArray2.swapWith (_points2);
-    vectorSize = signalFloatArray.size();
+    vectorSize = jmin (signalFloatArray.size(), signalFloatArray2.size());
 
     if (vectorSize > 0)
     {
         shouldPaint = true;
+        signalPathNeedsUpdate = true;
     }
 }
 
 //====================================================================================
-void CabbageSignalDisplay::timerCallback()
+void CabbageSignalDisplay::updateTapAnalyser()
+{
+    releaseTapAnalyser();
+    tapSources = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::tap);
+
+    const bool isSpectral = displayType == "spectroscope" || displayType == "spectrogram";
+    const int numTaps = displayType == "lissajous" ? 2 : 1;
+
+    if (tapSources.size() < numTaps || tapSources[0].toString().isEmpty())
+        return;
+
+    tapAnalyser = new CabbageTapAnalyser (isSpectral ? CabbageTapAnalyser::spectrum : CabbageTapAnalyser::samples,
+                                          isSpectral ? 2048 : 1024);
+
+    for (int i = 0; i < numTaps; i++)
+        if (CabbageAudioTap* tap = owner->addAudioTap (tapSources[i].toString()))
+            tapAnalyser->addTap (tap);
+
+    if (tapAnalyser->getNumTaps() < numTaps)
+    {
+        releaseTapAnalyser();
+        return;
+    }
+
+    owner->addSignalAnalyser (tapAnalyser);
+}
+
+//====================================================================================
+void CabbageSignalDisplay::releaseTapAnalyser()
 {
-    if (owner->shouldUpdateSignalDisplay())
+    if (tapAnalyser != nullptr)
+    {
+        owner->removeSignalAnalyser (tapAnalyser);
+
+        for (int i = 0; i < tapAnalyser->getNumTaps(); i++)
+            owner->removeAudioTap (tapAnalyser->getTap (i));
+
+        tapAnalyser = nullptr;
+    }
+
+    signalBuffers[0] = signalBuffers[1] = nullptr;
+    numDisplaysResolved = -1;
+}
+
+//====================================================================================
+void CabbageSignalDisplay::resolveSignalBuffers()
+{
+    signalBuffers[0] = signalBuffers[1] = nullptr;
+    lastFrames[0] = lastFrames[1] = 0;
+
+    if (tapAnalyser != nullptr)
+    {
+        for (int i = 0; i < tapAnalyser->getNumTaps(); i++)
+            signalBuffers[i] = tapAnalyser->getOutput (i);
+
+        return;
+    }
+
+    if (displayType != "lissajous")
     {
         const String variable = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::signalvariable);
-        const String displayType = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::displaytype);
+        signalBuffers[0] = owner->getSignalBuffer (variable, displayType);
+    }
+    else
+    {
+        var signalVariables = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::signalvariable);
 
-        if (displayType != "lissajous")
+        if (signalVariables.size() == 2)
         {
-            setSignalFloatArray (owner->getArrayForSignalDisplay (variable, displayType));
+            signalBuffers[0] = owner->getSignalBuffer (signalVariables[0], displayType);
+            signalBuffers[1] = owner->getSignalBuffer (signalVariables[1], displayType);
         }
-        else
-        {
-            var signalVariables = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::signalvariable);
+    }
+}
 
-            if (signalVariables.size() == 2)
-                setSignalFloatArraysForLissajous (owner->getArrayForSignalDisplay (signalVariables[0], displayType),
-                                                  owner->getArrayForSignalDisplay (signalVariables[1], displayType));
+//====================================================================================
+void CabbageSignalDisplay::timerCallback()
+{
+    const int numDisplays = owner->getNumSignalDisplays();
 
-        }
+    if (numDisplays != numDisplaysResolved)
+    {
+        resolveSignalBuffers();
+        numDisplaysResolved = numDisplays;
+    }
 
-        repaint();
+    //the frame numbers tell us whether Csound drew anything since the last tick
+    if (displayType != "lissajous")
+    {
+        if (signalBuffers[0] != nullptr && signalBuffers[0]->readLatest (lastFrames[0], signalFloatArray))
+        {
+            signalFrameReceived();
+            repaint();
+        }
     }
+    else if (signalBuffers[0] != nullptr && signalBuffers[1] != nullptr)
+    {
+        const bool first = signalBuffers[0]->readLatest (lastFrames[0], signalFloatArray);
+        const bool second = signalBuffers[1]->readLatest (lastFrames[1], signalFloatArray2);
 
+        if (first || second)
+        {
+            lissajousFramesReceived();
+            repaint();
+        }
+    }
 }
 
 //====================================================================================
@@ -335,6 +479,7 @@ void CabbageSignalDisplay::showPopup (String text)
 void CabbageSignalDisplay::resized()
 {
     scrollbarHeight = jmin (15.0, getHeight() * .09);
+    signalPathNeedsUpdate = true;
 
     if (!shouldDrawSonogram)
     {
@@ -355,6 +500,7 @@ void CabbageSignalDisplay::valueTreePropertyChanged (ValueTree& valueTree, const
         displayType = CabbageWidgetData::getStringProp (valueTree, CabbageIdentifierIds::displaytype);
 
         shouldDrawSonogram = displayType == "spectrogram" ? true : false;
+        updateTapAnalyser();
 
         if (shouldDrawSonogram)
         {
@@ -392,16 +538,22 @@ void CabbageSignalDisplay::valueTreePropertyChanged (ValueTree& valueTree, const
         freqRangeDisplay.setMinMax (freqRange.getStart(), freqRange.getEnd());
     }
 
+    if (tapSources != CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::tap))
+        updateTapAnalyser();
+
     if (signalVariables != CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::signalvariable))
     {
         signalVariables = CabbageWidgetData::getProperty (valueTree, CabbageIdentifierIds::signalvariable);
+        numDisplaysResolved = -1;
     }
 
+    spectrogram.setLogFrequencyScale (CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::logscale) == 1);
+
     if (updateRate != CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::updaterate))
     {
         updateRate = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::updaterate);
         startTimer (updateRate);
     }
 
-    handleCommonUpdates (this, valueTree);      //handle comon updates such as bounds, alpha, rotation, visible, etc
+    handleCommonUpdates (this, valueTree, false, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
 }
\ No newline at end of file
@@ -23,6 +23,9 @@
 
 #include "../CabbageCommonHeaders.h"
 #include "CabbageWidgetBase.h"
+#include "CabbageSpectrogramImage.h"
+#include "CabbageTapAnalyser.h"
+#include "../Audio/Plugins/CabbageSignalBuffer.h"
 
 #include "Legacy/FrequencyRangeDisplayComponent.h"
 
@@ -34,8 +37,15 @@ class CabbageSignalDisplay : public Component, public ValueTree::Listener, publi
 
     String name, displayType;
     RoundButton zoomInButton, zoomOutButton;
-    Array<float, CriticalSection> signalFloatArray;
-    Array<float, CriticalSection> signalFloatArray2;
+    Array<float> signalFloatArray;
+    Array<float> signalFloatArray2;
+    //resolved again whenever Csound registers a new graph or the variables change
+    CabbageSignalBuffer* signalBuffers[2] = { nullptr, nullptr };
+    int64 lastFrames[2] = { 0, 0 };
+    int numDisplaysResolved = -1;
+    //set when the widget reads audio taps rather than Csound's display opcodes
+    ScopedPointer<CabbageTapAnalyser> tapAnalyser;
+    var tapSources;
     var signalVariables;
     int tableNumber, freq, shouldDrawSonogram, leftPos, scrollbarHeight,
         minFFTBin, maxFFTBin, vectorSize, zoomLevel, scopeWidth, lineThickness;
@@ -44,9 +54,15 @@ class CabbageSignalDisplay : public Component, public ValueTree::Listener, publi
     bool isScrollbarShowing;
     float rotate;
     bool shouldPaint {false};
+    //the last frame reduced to what the widget's pixels can show, rebuilt only when the
+    //frame, size, zoom or scroll position changes
+    Path signalPath;
+    Array<float> columnMin, columnMax;
+    bool signalPathNeedsUpdate {false};
     int updateRate {100};
 
-    Image spectrogramImage, spectroscopeImage;
+    Image spectroscopeImage;
+    CabbageSpectrogramImage spectrogram;
     FrequencyRangeDisplayComponent freqRangeDisplay;
     Range<int> freqRange;
 
@@ -55,7 +71,7 @@ class CabbageSignalDisplay : public Component, public ValueTree::Listener, publi
 public:
 
     CabbageSignalDisplay (ValueTree wData, CabbagePluginEditor* owner);
-    ~CabbageSignalDisplay() {};
+    ~CabbageSignalDisplay();
 
     //ValueTree::Listener virtual methods....
     void valueTreePropertyChanged (ValueTree& valueTree, const Identifier&) override;
@@ -70,12 +86,16 @@ public:
     void scrollBarMoved (ScrollBar* scrollBarThatHasMoved, double newRangeStart);
     void changeListenerCallback (ChangeBroadcaster* source) override;
     void drawSonogram();
-    void drawSpectroscope (Graphics& g);
-    void drawWaveform (Graphics& g);
-    void drawLissajous (Graphics& g);
+    void updateSignalPath();
+    void updateSpectroscopePath();
+    void updateWaveformPath();
+    void updateLissajousPath();
     void paint (Graphics& g) override;
-    void setSignalFloatArray (Array<float, CriticalSection> _points);
-    void setSignalFloatArraysForLissajous (Array<float, CriticalSection> _points1, Array<float, CriticalSection> _points2);
+    void resolveSignalBuffers();
+    void updateTapAnalyser();
+    void releaseTapAnalyser();
+    void signalFrameReceived();
+    void lissajousFramesReceived();
     void resized() override;
     void mouseMove (const MouseEvent& e) override;
     void showPopup (String text);
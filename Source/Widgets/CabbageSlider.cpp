@@ -331,7 +331,7 @@ void CabbageSlider::valueTreePropertyChanged (ValueTree& valueTree, const Identi
         slider.getProperties().set ("trackerinnerradius", CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::trackerinsideradius));
         slider.getProperties().set ("trackerouterradius", CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::trackeroutsideradius));
         
-        handleCommonUpdates (this, valueTree);
+        handleCommonUpdates (this, valueTree, false, prop);
         setLookAndFeelColours (valueTree);
 
         //resized();
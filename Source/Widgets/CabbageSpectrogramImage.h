@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGESPECTROGRAMIMAGE_H_INCLUDED
+#define CABBAGESPECTROGRAMIMAGE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// The scrolling image behind signaldisplay's spectrogram mode. Each frame is written as a
+// single column straight into the image's pixels, using a colour lookup table rather than
+// building a Colour per bin. The image is circular. The write column moves along instead of
+// the whole image being shifted, and draw() puts the two halves back in order. Which bins
+// land on which row is worked out once per frame size, either linearly or on a log
+// frequency scale, and a row spanning several bins shows the loudest of them.
+//==============================================================================
+class CabbageSpectrogramImage
+{
+public:
+    CabbageSpectrogramImage (int width = 512, int height = 300)
+        : image (Image::RGB, width, height, true, SoftwareImageType()),
+          rowStart ((size_t) height), rowEnd ((size_t) height)
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            const float level = i / 255.f;
+            colourMap[i] = Colour::fromHSV (level, 1.0f, level, 1.0f).getPixelARGB();
+        }
+    }
+
+    void setLogFrequencyScale (bool shouldUseLogScale)
+    {
+        if (logScale != shouldUseLogScale)
+        {
+            logScale = shouldUseLogScale;
+            numBinsMapped = 0;
+        }
+    }
+
+    //writes the newest frame into the column after the previous one
+    void addFrame (const float* bins, int numBins)
+    {
+        if (numBins <= 0)
+            return;
+
+        if (numBins != numBinsMapped)
+            mapRowsToBins (numBins);
+
+        const float maxLevel = FloatVectorOperations::findMaximum (bins, numBins);
+        const int height = image.getHeight();
+        const Image::BitmapData bitmap (image, writeColumn, 0, 1, height, Image::BitmapData::writeOnly);
+
+        for (int row = 0; row < height; ++row)
+        {
+            float value = bins[rowStart[row]];
+
+            for (int bin = rowStart[row] + 1; bin < rowEnd[row]; ++bin)
+                value = jmax (value, bins[bin]);
+
+            const float level = value / jmax (maxLevel, value + 0.1f);
+            reinterpret_cast<PixelRGB*> (bitmap.getLinePointer (row))->set (colourMap[jlimit (0, 255, roundToInt (level * 255.f))]);
+        }
+
+        writeColumn = (writeColumn + 1) % image.getWidth();
+    }
+
+    //draws the oldest column at the left edge of area and the newest one at the right
+    void draw (Graphics& g, Rectangle<int> area) const
+    {
+        const int width = image.getWidth();
+        const int height = image.getHeight();
+        const int split = area.getWidth() * (width - writeColumn) / width;
+
+        g.drawImage (image, area.getX(), area.getY(), split, area.getHeight(), writeColumn, 0, width - writeColumn, height);
+
+        if (writeColumn > 0)
+            g.drawImage (image, area.getX() + split, area.getY(), area.getWidth() - split, area.getHeight(), 0, 0, writeColumn, height);
+    }
+
+    //the fraction of the spectrum shown at a given height, 0 being the top of the image
+    double getProportionOfSpectrum (double proportionFromTop) const
+    {
+        const double y = 1.0 - jlimit (0.0, 1.0, proportionFromTop);
+
+        if (logScale && numBinsMapped > 2)
+            return std::pow ((double) numBinsMapped, y) / numBinsMapped;
+
+        return y;
+    }
+
+private:
+    //row 0 is the top of the image and shows the highest frequencies
+    void mapRowsToBins (int numBins)
+    {
+        const int height = image.getHeight();
+        const double lowestBin = jmin (1.0, numBins - 1.0);
+
+        for (int row = 0; row < height; ++row)
+        {
+            const double y = height - 1 - row;
+            int start, end;
+
+            if (logScale && numBins > 2)
+            {
+                start = (int) (lowestBin * std::pow (numBins / lowestBin, y / height));
+                end = (int) (lowestBin * std::pow (numBins / lowestBin, (y + 1) / height));
+            }
+            else
+            {
+                start = (int) (y * numBins / height);
+                end = (int) ((y + 1) * numBins / height);
+            }
+
+            rowStart[row] = jlimit (0, numBins - 1, start);
+            rowEnd[row] = jlimit (rowStart[row] + 1, numBins, end);
+        }
+
+        numBinsMapped = numBins;
+    }
+
+    Image image;
+    PixelARGB colourMap[256];
+    HeapBlock<int> rowStart, rowEnd;
+    int numBinsMapped = 0;
+    int writeColumn = 0;
+    bool logScale = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageSpectrogramImage)
+};
+
+#endif  // CABBAGESPECTROGRAMIMAGE_H_INCLUDED
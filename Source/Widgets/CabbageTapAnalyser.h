@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGETAPANALYSER_H_INCLUDED
+#define CABBAGETAPANALYSER_H_INCLUDED
+
+#include <complex>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Audio/Plugins/CabbageAudioTap.h"
+#include "../Audio/Plugins/CabbageSignalBuffer.h"
+
+//==============================================================================
+// Turns the samples of one or two audio taps into display frames for signaldisplay. It
+// runs as a client of the editor's analysis thread, so the windowing and FFT never touch
+// the audio thread and stop as soon as the editor, and with it the widget, goes away.
+// In spectrum mode the newest frame of the first tap is Hann windowed and reduced to
+// frameSize / 2 magnitudes, scaled so that a full scale sine reads 1. In samples mode the
+// newest frameSize samples of every tap are passed on as they are, taken at the same
+// moment so that a Lissajous figure of two taps lines up. JUCE's dsp module is not part
+// of this tree, so the FFT is a plain radix-2 one, plenty for display sizes.
+//==============================================================================
+class CabbageTapAnalyser : public TimeSliceClient
+{
+public:
+    enum Mode
+    {
+        spectrum,
+        samples
+    };
+
+    CabbageTapAnalyser (Mode analysisMode, int frameSizeToUse = 2048)
+        : mode (analysisMode),
+          frameSize (nextPowerOfTwo (jlimit (64, 8192, frameSizeToUse)))
+    {
+        for (auto& frame : frames)
+            frame.allocate ((size_t) frameSize, true);
+
+        if (mode == spectrum)
+        {
+            window.allocate ((size_t) frameSize, false);
+            fftData.allocate ((size_t) frameSize, true);
+            twiddles.allocate ((size_t) frameSize / 2, false);
+            bitReversed.allocate ((size_t) frameSize, false);
+
+            for (int i = 0; i < frameSize; ++i)
+                window[i] = 0.5f - 0.5f * std::cos (MathConstants<float>::twoPi * i / frameSize);
+
+            for (int i = 0; i < frameSize / 2; ++i)
+                twiddles[i] = std::polar (1.0f, -MathConstants<float>::twoPi * i / frameSize);
+
+            const int numBits = roundToInt (std::log2 ((double) frameSize));
+
+            for (int i = 0; i < frameSize; ++i)
+            {
+                int reversed = 0;
+
+                for (int bit = 0; bit < numBits; ++bit)
+                    reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+
+                bitReversed[i] = reversed;
+            }
+        }
+    }
+
+    //call before the analyser is handed to a thread, in samples mode each tap gets its own output
+    void addTap (CabbageAudioTap* tap)
+    {
+        jassert (tap != nullptr && numTaps < maxNumTaps && (mode == samples || numTaps == 0));
+        taps[numTaps] = tap;
+        outputs[numTaps] = new CabbageSignalBuffer (mode == spectrum ? frameSize / 2 : frameSize);
+        ++numTaps;
+    }
+
+    int getNumTaps() const noexcept                         { return numTaps; }
+    CabbageAudioTap* getTap (int index) const noexcept      { return taps[index]; }
+    CabbageSignalBuffer* getOutput (int index) const        { return outputs[index].get(); }
+
+    int useTimeSlice() override
+    {
+        if (numTaps == 0)
+            return -1;
+
+        int64 writePositions[maxNumTaps];
+        bool hasNewSamples = false;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            writePositions[i] = taps[i]->getWritePosition();
+            hasNewSamples = hasNewSamples || writePositions[i] != lastWritePositions[i];
+        }
+
+        if (! hasNewSamples)
+            return idleInterval;
+
+        for (int i = 0; i < numTaps; ++i)
+            if (taps[i]->read (frames[i], frameSize, writePositions[i]) < 0)
+                return idleInterval;
+
+        //a tap moved on while the others were being read, try again straight away
+        for (int i = 0; i < numTaps; ++i)
+            if (taps[i]->getWritePosition() != writePositions[i])
+                return 1;
+
+        for (int i = 0; i < numTaps; ++i)
+            lastWritePositions[i] = writePositions[i];
+
+        if (mode == spectrum)
+        {
+            computeMagnitudes();
+            outputs[0]->publish (frames[0].get(), frameSize / 2);
+        }
+        else
+        {
+            for (int i = 0; i < numTaps; ++i)
+                outputs[i]->publish (frames[i].get(), frameSize);
+        }
+
+        return frameInterval;
+    }
+
+private:
+    //windows frames[0] and replaces its first half with the magnitude of each bin
+    void computeMagnitudes() noexcept
+    {
+        for (int i = 0; i < frameSize; ++i)
+            fftData[bitReversed[i]] = std::complex<float> (frames[0][i] * window[i], 0.0f);
+
+        for (int length = 2; length <= frameSize; length <<= 1)
+        {
+            const int half = length / 2;
+            const int twiddleStep = frameSize / length;
+
+            for (int start = 0; start < frameSize; start += length)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    const std::complex<float> odd = fftData[start + k + half] * twiddles[k * twiddleStep];
+                    fftData[start + k + half] = fftData[start + k] - odd;
+                    fftData[start + k] += odd;
+                }
+            }
+        }
+
+        //the Hann window sums to frameSize / 2
+        const float scale = 4.0f / frameSize;
+
+        for (int i = 0; i < frameSize / 2; ++i)
+            frames[0][i] = std::abs (fftData[i]) * scale;
+    }
+
+    enum { maxNumTaps = 2, idleInterval = 10, frameInterval = 20 };
+
+    const Mode mode;
+    const int frameSize;
+    int numTaps = 0;
+    CabbageAudioTap* taps[maxNumTaps] = { nullptr, nullptr };
+    ScopedPointer<CabbageSignalBuffer> outputs[maxNumTaps];
+    int64 lastWritePositions[maxNumTaps] = { 0, 0 };
+    HeapBlock<float> frames[maxNumTaps];
+    HeapBlock<float> window;
+    HeapBlock<std::complex<float>> fftData, twiddles;
+    HeapBlock<int> bitReversed;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageTapAnalyser)
+};
+
+#endif  // CABBAGETAPANALYSER_H_INCLUDED
@@ -48,9 +48,17 @@ void CabbageWidgetBase::initialiseCommonAttributes (Component* child, ValueTree
     handleCommonUpdates (child, data, true);
 }
 
-void CabbageWidgetBase::handleCommonUpdates (Component* child, ValueTree data, bool calledFromConstructor)
+void CabbageWidgetBase::handleCommonUpdates (Component* child, ValueTree data, bool calledFromConstructor, const Identifier& changedProperty)
 {
-    if (calledFromConstructor == false)
+    //when widgets pass on the property that changed, only the state that depends on it is read
+    const bool updateAll = calledFromConstructor || changedProperty.isNull();
+    const Identifier& prop = changedProperty;
+
+    const bool boundsChanged = updateAll || prop == CabbageIdentifierIds::left || prop == CabbageIdentifierIds::top
+                               || prop == CabbageIdentifierIds::width || prop == CabbageIdentifierIds::height
+                               || prop == CabbageIdentifierIds::allowboundsupdate;
+
+    if (calledFromConstructor == false && boundsChanged)
     {
         if (getPluginEditor (child) != nullptr && getPluginEditor (child)->isEditModeEnabled() == false)
             child->setBounds (CabbageWidgetData::getBounds (data));
@@ -62,7 +70,8 @@ void CabbageWidgetBase::handleCommonUpdates (Component* child, ValueTree data, b
         }
     }
 
-    if ( rotate != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::rotate) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::rotate)
+        && ( rotate != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::rotate) || calledFromConstructor))
     {
         rotate = CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::rotate);
         child->setTransform (AffineTransform::rotation ( rotate, child->getX() + CabbageWidgetData::getNumProp (data,
@@ -70,25 +79,29 @@ void CabbageWidgetBase::handleCommonUpdates (Component* child, ValueTree data, b
                                                          child->getY() + CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::pivoty)));
     }
 
-    if ( toFront != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::tofront) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::tofront)
+        && ( toFront != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::tofront) || calledFromConstructor))
     {
         toFront = CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::tofront);
         child->toFront(true);
     }
 
-    if ( visible != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::visible) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::visible)
+        && ( visible != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::visible) || calledFromConstructor))
     {
         visible = CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::visible);
         child->setVisible ( visible == 1 ? true : false);
         child->setEnabled ( visible == 1 ? true : false);
     }
 
-    if (text != CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::text) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::text)
+        && (text != CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::text) || calledFromConstructor))
     {
         text = CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::text);
     }
 
-    if ( active != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::active) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::active)
+        && ( active != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::active) || calledFromConstructor))
     {
         //string sequencer uses active to stop sequencing..
         active = CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::active);
@@ -96,18 +109,21 @@ void CabbageWidgetBase::handleCommonUpdates (Component* child, ValueTree data, b
         child->setEnabled ( active == 1 ? true : false);
     }
 
-    if ( alpha != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::alpha) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::alpha)
+        && ( alpha != CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::alpha) || calledFromConstructor))
     {
         alpha = CabbageWidgetData::getNumProp (data, CabbageIdentifierIds::alpha);
         child->setAlpha ( alpha);
     }
 
-    if ( file != CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::file) || calledFromConstructor)
+    if ((updateAll || prop == CabbageIdentifierIds::file)
+        && ( file != CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::file) || calledFromConstructor))
     {
         file = CabbageWidgetData::getStringProp (data, CabbageIdentifierIds::file);
     }
 
-    populateTextArrays (data);
+    if (updateAll || prop == CabbageIdentifierIds::text || prop == CabbageIdentifierIds::channel)
+        populateTextArrays (data);
 }
 
 String CabbageWidgetBase::getCurrentText (ValueTree data)
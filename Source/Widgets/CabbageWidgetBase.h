@@ -119,7 +119,8 @@ public:
         file = val;
     }
     void initialiseCommonAttributes (Component* child, ValueTree valueTree);                        //handles simple attributes on initialisation
-    void handleCommonUpdates (Component* child, ValueTree data, bool calledFromConstructor = false); //handles all updates from ident channel message
+    void handleCommonUpdates (Component* child, ValueTree data, bool calledFromConstructor = false,
+                              const Identifier& changedProperty = Identifier());                  //handles all updates from ident channel message
 
     //see below file for implementation
     template< typename Type >
@@ -20,17 +20,13 @@
 
 
 #include "CabbageWidgetData.h"
+#include "CabbageLineLexer.h"
 #define MAX_MATRIX_SIZE 64
 
 //#include "CabbageWidgetDataInitMethods.cpp"
 //===============================================================================
 // Main Cabbage abstract GUI class
 //===============================================================================
-constexpr unsigned long long int HashStringToInt (const char* str, unsigned long long int hash = 0)
-{
-    return (*str == 0) ? hash : 101 * HashStringToInt (str + 1) + *str;
-}
-//===============================================================================
 void CabbageWidgetData::setWidgetState (ValueTree widgetData, String lineFromCsd, int ID)
 {
     setProperty (widgetData, "scalex", 1);
@@ -57,107 +53,106 @@ void CabbageWidgetData::setWidgetState (ValueTree widgetData, String lineFromCsd
     setProperty (widgetData, CabbageIdentifierIds::typeface, "");
     setProperty (widgetData, CabbageIdentifierIds::surrogatelinenumber, -99);
 
-    StringArray strTokens;
-    strTokens.addTokens (lineFromCsd, " ", "\"");
+    const String typeOfWidget = CabbageLineLexer::getWidgetType (lineFromCsd);
 
-    if(strTokens.size()>0)
-        setProperty (widgetData, CabbageIdentifierIds::type, strTokens[0].trim());
+    if (lineFromCsd.isNotEmpty())
+        setProperty (widgetData, CabbageIdentifierIds::type, typeOfWidget);
 
     setProperty (widgetData, CabbageIdentifierIds::widgetarray, "");
 
-    if (strTokens[0].trim() == String(CabbageWidgetTypes::hslider))
+    if (typeOfWidget == String(CabbageWidgetTypes::hslider))
         setHSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::vslider))
+    else if (typeOfWidget == String(CabbageWidgetTypes::vslider))
         setVSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::rslider))
+    else if (typeOfWidget == String(CabbageWidgetTypes::rslider))
         setRSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::groupbox))
+    else if (typeOfWidget == String(CabbageWidgetTypes::groupbox))
         setGroupBoxProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::csoundoutput))
+    else if (typeOfWidget == String(CabbageWidgetTypes::csoundoutput))
         setCsoundOutputProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::keyboard) || 
-		strTokens[0].trim() == String(CabbageWidgetTypes::keyboarddisplay))
-        setKeyboardProperties (widgetData, ID, (strTokens[0].trim() == "keyboard" ? false : true));
+    else if (typeOfWidget == String(CabbageWidgetTypes::keyboard) || 
+		typeOfWidget == String(CabbageWidgetTypes::keyboarddisplay))
+        setKeyboardProperties (widgetData, ID, (typeOfWidget == "keyboard" ? false : true));
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::form))
+    else if (typeOfWidget == String(CabbageWidgetTypes::form))
         setFormProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::textbox))
+    else if (typeOfWidget == String(CabbageWidgetTypes::textbox))
         setTextBoxProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::checkbox))
+    else if (typeOfWidget == String(CabbageWidgetTypes::checkbox))
         setCheckBoxProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::nslider))
+    else if (typeOfWidget == String(CabbageWidgetTypes::nslider))
         setNumberSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::combobox))
+    else if (typeOfWidget == String(CabbageWidgetTypes::combobox))
         setComboBoxProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::label))
+    else if (typeOfWidget == String(CabbageWidgetTypes::label))
         setLabelProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::listbox))
+    else if (typeOfWidget == String(CabbageWidgetTypes::listbox))
         setListBoxProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::texteditor))
+    else if (typeOfWidget == String(CabbageWidgetTypes::texteditor))
         setTextEditorProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::image))
+    else if (typeOfWidget == String(CabbageWidgetTypes::image))
         setImageProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::encoder))
+    else if (typeOfWidget == String(CabbageWidgetTypes::encoder))
         setEncoderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::hmeter))
+    else if (typeOfWidget == String(CabbageWidgetTypes::hmeter))
         setMeterProperties (widgetData, ID, false);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::vmeter))
+    else if (typeOfWidget == String(CabbageWidgetTypes::vmeter))
         setMeterProperties (widgetData, ID, true);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::button))
+    else if (typeOfWidget == String(CabbageWidgetTypes::button))
         setButtonProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::soundfiler))
+    else if (typeOfWidget == String(CabbageWidgetTypes::soundfiler))
         setSoundfilerProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::filebutton))
+    else if (typeOfWidget == String(CabbageWidgetTypes::filebutton))
         setFileButtonProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::infobutton))
+    else if (typeOfWidget == String(CabbageWidgetTypes::infobutton))
         setInfoButtonProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::line))
+    else if (typeOfWidget == String(CabbageWidgetTypes::line))
         setLineProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::sourcebutton) || strTokens[0].trim() == String(CabbageWidgetTypes::loadbutton))
+    else if (typeOfWidget == String(CabbageWidgetTypes::sourcebutton) || typeOfWidget == String(CabbageWidgetTypes::loadbutton))
         setLoadButtonProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::signaldisplay) || strTokens[0].trim() == String(CabbageWidgetTypes::fftdisplay))
+    else if (typeOfWidget == String(CabbageWidgetTypes::signaldisplay) || typeOfWidget == String(CabbageWidgetTypes::fftdisplay))
         setSignalDisplayProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::xypad))
+    else if (typeOfWidget == String(CabbageWidgetTypes::xypad))
         setXYPadProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::gentable))
+    else if (typeOfWidget == String(CabbageWidgetTypes::gentable))
         setGenTableProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::hrange))
+    else if (typeOfWidget == String(CabbageWidgetTypes::hrange))
         setHRangeSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::vrange))
+    else if (typeOfWidget == String(CabbageWidgetTypes::vrange))
         setVRangeSliderProperties (widgetData, ID);
 
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::eventsequencer))
+    else if (typeOfWidget == String(CabbageWidgetTypes::eventsequencer))
         setEventSequencerProperties (widgetData, ID);
 
     //===============table==================//
-    else if (strTokens[0].trim() == String(CabbageWidgetTypes::table))
+    else if (typeOfWidget == String(CabbageWidgetTypes::table))
     {
         setProperty (widgetData, "basetype", "layout");
         var tableColours;
@@ -186,7 +181,7 @@ void CabbageWidgetData::setWidgetState (ValueTree widgetData, String lineFromCsd
     }
 
     //===============stepper example==================//
-    else if (strTokens[0].trim() == "stepper")
+    else if (typeOfWidget == "stepper")
     {
         setProperty (widgetData, "basetype", "layout");
         setProperty (widgetData, CabbageIdentifierIds::top, 10);
@@ -202,35 +197,35 @@ void CabbageWidgetData::setWidgetState (ValueTree widgetData, String lineFromCsd
     }
 
     //===============non-GUI host widgets==================//
-    else if (strTokens[0].trim() == "hostbpm")
+    else if (typeOfWidget == "hostbpm")
     {
         setProperty (widgetData, CabbageIdentifierIds::basetype, "layout");
         setProperty (widgetData, CabbageIdentifierIds::name, "hostbpm");
         setProperty (widgetData, CabbageIdentifierIds::type, "hostbpm");
     }
 
-    else if (strTokens[0].trim() == "hostppqpos")
+    else if (typeOfWidget == "hostppqpos")
     {
         setProperty (widgetData, CabbageIdentifierIds::basetype, "layout");
         setProperty (widgetData, CabbageIdentifierIds::name, "hostppqpos");
         setProperty (widgetData, CabbageIdentifierIds::type, "hostppqpos");
     }
 
-    else if (strTokens[0].trim() == "hostplaying")
+    else if (typeOfWidget == "hostplaying")
     {
         setProperty (widgetData, CabbageIdentifierIds::basetype, "layout");
         setProperty (widgetData, CabbageIdentifierIds::name, "hostplaying");
         setProperty (widgetData, CabbageIdentifierIds::type, "hostplaying");
     }
 
-    else if (strTokens[0].trim() == "hostrecording")
+    else if (typeOfWidget == "hostrecording")
     {
         setProperty (widgetData, CabbageIdentifierIds::basetype, "layout");
         setProperty (widgetData, CabbageIdentifierIds::name, "hostrecording");
         setProperty (widgetData, CabbageIdentifierIds::type, "hostrecording");
     }
 
-    else if (strTokens[0].trim() == "hosttime")
+    else if (typeOfWidget == "hosttime")
     {
         setProperty (widgetData, CabbageIdentifierIds::basetype, "layout");
         setProperty (widgetData, CabbageIdentifierIds::name, "hosttime");
@@ -238,7 +233,7 @@ void CabbageWidgetData::setWidgetState (ValueTree widgetData, String lineFromCsd
     }
     else
     {
-        setProperty (widgetData, CabbageIdentifierIds::type, strTokens[0]);
+        setProperty (widgetData, CabbageIdentifierIds::type, typeOfWidget);
     }
 
     //parse the text now that all default values ahve been assigned
@@ -270,23 +265,12 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
         lineOfText = lineOfText.substring (lineOfText.indexOf (typeOfWidget) + typeOfWidget.length()).trim();
     }
 
-    IdentifiersAndParameters identifierValueSet = getSetofIdentifiersAndParameters (lineOfText);
-
-    CabbageIdentifierStrings identifierArray;
+    //identifiers and their arguments are read in place, strings are only made where they get stored
+    CabbageLineLexer identifiers (lineOfText);
 
-
-    for ( int indx = 0 ; indx < identifierValueSet.identifier.size() ; indx++)
+    while (identifiers.next())
     {
-        //CabbageUtilities::debug(identifierValueSet.identifier[indx]);
-        StringArray strTokens;
-        String identifier = identifierValueSet.identifier[indx].trimCharactersAtStart (" ");
-
-        if (identifier.indexOf (":") != -1)
-            identifier = identifier.substring (0, identifier.indexOf (":") + 1);
-
-        strTokens = CabbageUtilities::getTokens (identifierValueSet.parameter[indx], ',');
-
-        switch (HashStringToInt (identifier.toStdString().c_str()))
+        switch (identifiers.getHash())
         {
             //======== strings ===============================
             case HashStringToInt ("kind"):
@@ -296,9 +280,7 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("popuptext"):
             case HashStringToInt ("mode"):
             case HashStringToInt ("channeltype"):
-            case HashStringToInt ("popuppostfix"):
             case HashStringToInt ("orientation"):
-            case HashStringToInt ("popupprefix"):
             case HashStringToInt ("identchannel"):
             case HashStringToInt ("author"):
             case HashStringToInt ("align"):
@@ -314,42 +296,48 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("manufacturer"):
             case HashStringToInt ("logger"):
             case HashStringToInt ("namespace"):
-                setProperty (widgetData, identifier, (identifier.contains("fix") ? strTokens[0] : strTokens[0].trim()));
+                setProperty (widgetData, identifiers.getIdentifier(), identifiers.getArg (0).trim());
+                break;
+
+            //spaces at either end are part of a prefix or postfix
+            case HashStringToInt ("popuppostfix"):
+            case HashStringToInt ("popupprefix"):
+                setProperty (widgetData, identifiers.getIdentifier(), identifiers.getArg (0));
                 break;
 
             case HashStringToInt ("channel"):
             case HashStringToInt ("channels"):
-                setChannelArrays (strTokens, widgetData, identifier);
+                setChannelArrays (identifiers.getArgs(), widgetData, identifiers.getIdentifier().toString());
                 break;
 
             case HashStringToInt ("channelarray"):
             case HashStringToInt ("widgetarray"):
-                setChannelArrays (strTokens, widgetData, identifier);
+                setChannelArrays (identifiers.getArgs(), widgetData, identifiers.getIdentifier().toString());
                 break;
 
             case HashStringToInt ("items"):
             case HashStringToInt ("text"):
-                setTextItemArrays (strTokens, widgetData, getStringProp(widgetData, CabbageIdentifierIds::type));
+                setTextItemArrays (identifiers.getArgs(), widgetData, getStringProp(widgetData, CabbageIdentifierIds::type));
                 break;
 
             case HashStringToInt ("populate"):
-                setPopulateProps (strTokens, widgetData);
+                setPopulateProps (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("imgfile"):
-                setImageFiles (strTokens, widgetData, getStringProp(widgetData, CabbageIdentifierIds::type));
+                setImageFiles (identifiers.getArgs(), widgetData, getStringProp(widgetData, CabbageIdentifierIds::type));
                 break;
 
             case HashStringToInt ("shape"):
-                setShapes (strTokens, widgetData);
+                setShapes (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("import"):
-                addFiles (strTokens, widgetData, "import");
+                addFiles (identifiers.getArgs(), widgetData, "import");
                 break;
 
             case HashStringToInt ("bundle"):
-                addFiles (strTokens, widgetData, "bundle");
+                addFiles (identifiers.getArgs(), widgetData, "bundle");
                 break;
 
             //=========== floats ===============================
@@ -371,6 +359,7 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("alpha"):
             case HashStringToInt ("corners"):
             case HashStringToInt ("guirefresh"):
+            case HashStringToInt ("idletime"):
             case HashStringToInt ("textbox"):
             case HashStringToInt ("valuetextbox"):
             case HashStringToInt ("velocity"):
@@ -383,6 +372,7 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("valuex"):
             case HashStringToInt ("valuey"):
             case HashStringToInt ("zoom"):
+            case HashStringToInt ("logscale"):
             case HashStringToInt ("wrap"):
             case HashStringToInt ("refreshfiles"):
             case HashStringToInt ("readonly"):
@@ -392,53 +382,61 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("markerstart"):
             case HashStringToInt ("markerend"):
                 if (getStringProp (widgetData, CabbageIdentifierIds::channeltype) == "string")
-                    setProperty (widgetData, identifier, strTokens[0].trim());
+                    setProperty (widgetData, identifiers.getIdentifier(), identifiers.getArg (0).trim());
                 else
-                    setProperty (widgetData, identifier, strTokens[0].trim().getFloatValue());
+                    setProperty (widgetData, identifiers.getIdentifier(), identifiers.getFloat (0));
 
                 break;
 
             case HashStringToInt ("crop"):
-                setProperty (widgetData, CabbageIdentifierIds::cropx, strTokens[0].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::cropy, strTokens[1].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::cropwidth, strTokens[2].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::cropheight, strTokens[3].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::cropx, identifiers.getFloat (0));
+                setProperty (widgetData, CabbageIdentifierIds::cropy, identifiers.getFloat (1));
+                setProperty (widgetData, CabbageIdentifierIds::cropwidth, identifiers.getFloat (2));
+                setProperty (widgetData, CabbageIdentifierIds::cropheight, identifiers.getFloat (3));
                 break;
 
             case HashStringToInt ("max"):
                 setProperty (widgetData, CabbageIdentifierIds::maxenabled, 1);
-                setProperty (widgetData, CabbageIdentifierIds::max, strTokens[0].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::max, identifiers.getFloat (0));
                 break;
 
             case HashStringToInt ("min"):
                 setProperty (widgetData, CabbageIdentifierIds::minenabled, 1);
-                setProperty (widgetData, CabbageIdentifierIds::min, strTokens[0].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::min, identifiers.getFloat (0));
                 break;
 
             case HashStringToInt ("range"):
             case HashStringToInt ("rangex"):
             case HashStringToInt ("rangey"):
-                setRange (strTokens, widgetData, identifier);
+                setRange (identifiers.getArgs(), widgetData, identifiers.getIdentifier().toString());
                 break;
 
             case HashStringToInt ("rotate"):
-                setProperty (widgetData, CabbageIdentifierIds::rotate, strTokens[0].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::pivotx, strTokens[1].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::pivoty, strTokens[2].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::rotate, identifiers.getFloat (0));
+                setProperty (widgetData, CabbageIdentifierIds::pivotx, identifiers.getFloat (1));
+                setProperty (widgetData, CabbageIdentifierIds::pivoty, identifiers.getFloat (2));
                 break;
 
             case HashStringToInt ("amprange"):
-                setAmpRange (strTokens, widgetData);
+                setAmpRange (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("rescale"):
-                setProperty (widgetData, CabbageIdentifierIds::scalex, strTokens[0].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::scaley, strTokens[1].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::scalex, identifiers.getFloat (0));
+                setProperty (widgetData, CabbageIdentifierIds::scaley, identifiers.getFloat (1));
                 break;
 
             //============= ints ===========================
             case HashStringToInt ("signalvariable"):
-                setProperty (widgetData, CabbageIdentifierIds::signalvariable, getVarArrayFromTokens (strTokens));
+                setProperty (widgetData, CabbageIdentifierIds::signalvariable, getVarArrayFromTokens (identifiers.getArgs()));
+                break;
+
+            case HashStringToInt ("tap"):
+                setProperty (widgetData, CabbageIdentifierIds::tap, getVarArrayFromTokens (identifiers.getArgs()));
+                break;
+
+            case HashStringToInt ("metersource"):
+                setProperty (widgetData, CabbageIdentifierIds::metersource, getVarArrayFromTokens (identifiers.getArgs()));
                 break;
 
             case HashStringToInt ("popup"):
@@ -449,50 +447,50 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("cellheight"):
             case HashStringToInt ("resize"):
             case HashStringToInt ("gapmarkers"):
-                setProperty (widgetData, identifier, strTokens[0].trim().getIntValue());
+                setProperty (widgetData, identifiers.getIdentifier(), identifiers.getInt (0));
                 break;
                 break;
 
             case HashStringToInt ("tablenumber"):
             case HashStringToInt ("tablenumbers"):
-                setTableNumberArrays (strTokens, widgetData);
+                setTableNumberArrays (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("size"):
-                if (strTokens.size() >= 2)
+                if (identifiers.getNumArgs() >= 2)
                 {
-                    setProperty (widgetData, CabbageIdentifierIds::width, strTokens[0].trim().getFloatValue());
-                    setProperty (widgetData, CabbageIdentifierIds::height, strTokens[1].trim().getFloatValue());
+                    setProperty (widgetData, CabbageIdentifierIds::width, identifiers.getFloat (0));
+                    setProperty (widgetData, CabbageIdentifierIds::height, identifiers.getFloat (1));
                 }
 
                 break;
 
             case HashStringToInt ("bounds"):
-                setBounds (strTokens, widgetData);
+                setBounds (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("pos"):
-                setProperty (widgetData, CabbageIdentifierIds::left, strTokens[0].trim().getFloatValue());
-                setProperty (widgetData, CabbageIdentifierIds::top, strTokens[1].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::left, identifiers.getFloat (0));
+                setProperty (widgetData, CabbageIdentifierIds::top, identifiers.getFloat (1));
                 break;
 
             case HashStringToInt ("fontstyle"):
-                setFontStyle (strTokens, widgetData);
+                setFontStyle (identifiers.getArgs(), widgetData);
                 break;
 
             case HashStringToInt ("scrubberposition"):
-                setScrubberPosition (strTokens, widgetData);
+                setScrubberPosition (identifiers.getArgs(), widgetData);
                 break;
 
 			case HashStringToInt("keypressed"):
-				setKeyboardDisplayNotes(strTokens, widgetData);
+				setKeyboardDisplayNotes(identifiers.getArgs(), widgetData);
 				break;
 
             case HashStringToInt ("samplerange"):
-                setProperty (widgetData, CabbageIdentifierIds::startpos, strTokens[0].trim().getFloatValue());
+                setProperty (widgetData, CabbageIdentifierIds::startpos, identifiers.getFloat (0));
 
-                if (strTokens.size() > 1)
-                    setProperty (widgetData, CabbageIdentifierIds::endpos, strTokens[1].trim().getFloatValue());
+                if (identifiers.getNumArgs() > 1)
+                    setProperty (widgetData, CabbageIdentifierIds::endpos, identifiers.getFloat (1));
                 else
                     setProperty (widgetData, CabbageIdentifierIds::endpos, -1);
 
@@ -524,37 +522,37 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, String lineO
             case HashStringToInt ("textboxcolour"):
             case HashStringToInt ("textboxoutlinecolour"):
             case HashStringToInt ("markercolour"):
-                setProperty (widgetData, identifier, getColourFromText (strTokens.joinIntoString (",")).toString());
+                setProperty (widgetData, identifiers.getIdentifier(), getColourFromText (identifiers.getArgs().joinIntoString (",")).toString());
                 break;
 
             case HashStringToInt ("colour:"):
             case HashStringToInt ("colour"):
             case HashStringToInt ("fontcolour:"):
             case HashStringToInt ("fontcolour"):
-                setColourByNumber (strTokens, widgetData, identifierValueSet.identifier[indx]);
+                setColourByNumber (identifiers.getArgs(), widgetData, identifiers.getFullIdentifier());
                 break;
 
             case HashStringToInt ("tablecolour"):
             case HashStringToInt ("tablecolours"):
             case HashStringToInt ("tablecolour:"):
-                setColourArrays (strTokens, widgetData, identifierValueSet.identifier[indx]);
+                setColourArrays (identifiers.getArgs(), widgetData, identifiers.getFullIdentifier());
                 break;
 
             case HashStringToInt ("metercolour"):
             case HashStringToInt ("metercolour:"):
-                setColourArrays (strTokens, widgetData, identifierValueSet.identifier[indx], false);
+                setColourArrays (identifiers.getArgs(), widgetData, identifiers.getFullIdentifier(), false);
                 break;
 
             //matrix event props
             case HashStringToInt ("celldata"):
-                setCellData(strTokens, identifierValueSet.parameter[indx], widgetData);
+                setCellData(identifiers.getArgs(), identifiers.getParameter(), widgetData);
                 break;
 			case HashStringToInt("rowprefix"):
 			case HashStringToInt("colprefix"):
-				setMatrixPrefix(strTokens, identifierValueSet.parameter[indx], widgetData, identifierValueSet.identifier[indx]);
+				setMatrixPrefix(identifiers.getArgs(), identifiers.getParameter(), widgetData, identifiers.getFullIdentifier());
 				break;
             case HashStringToInt( ("matrixsize")):
-                setMatrixSize(strTokens, widgetData);
+                setMatrixSize(identifiers.getArgs(), widgetData);
             default:
                 break;
 
@@ -576,42 +574,6 @@ var CabbageWidgetData::getVarArrayFromTokens (StringArray strTokens)
     return array;
 }
 
-CabbageWidgetData::IdentifiersAndParameters CabbageWidgetData::getSetofIdentifiersAndParameters (String lineOfText)
-{
-    StringArray identifiersInLine = CabbageUtilities::getTokens (lineOfText.substring (0, lineOfText.lastIndexOf (")")+1).trimCharactersAtStart ("), "), ')');
-
-    StringArray parameters;
-
-    for ( int i = 0 ; i < identifiersInLine.size() ; i++)
-        identifiersInLine.set (i, identifiersInLine[i].trim().trimCharactersAtStart (" ,") + ")");
-
-    for ( int i = 0 ; i < identifiersInLine.size() ; i++)
-    {
-        String parameter = identifiersInLine[i];
-        parameter = parameter.substring (parameter.indexOf ("(") + 1, parameter.lastIndexOf (")")).trimCharactersAtStart ("\"").trimCharactersAtEnd ("\"");
-        parameters.add (parameter);
-    }
-
-    for ( int i = 0 ; i < identifiersInLine.size() ; i++)
-    {
-        const String newToken = identifiersInLine[i];
-        identifiersInLine.set (i, newToken.substring (0, newToken.indexOf ("(")));
-    }
-
-    IdentifiersAndParameters valueSet;
-    identifiersInLine.removeEmptyStrings();
-
-    for ( int i = 0 ; i < identifiersInLine.size() ; i++)
-    {
-        valueSet.identifier.add (identifiersInLine[i].removeCharacters(" "));
-        valueSet.parameter.add (parameters[i].removeCharacters ("\""));
-    }
-
-
-    return valueSet;
-
-}
-
 String CabbageWidgetData::replaceIdentifier (String line, String identifier, String updatedIdentifier)
 {
     if(identifier == CabbageIdentifierIds::importfiles.toString())
@@ -34,12 +34,6 @@ class CabbageWidgetData : public CabbageUtilities
 
 public:
 
-    struct IdentifiersAndParameters
-    {
-        StringArray identifier;
-        StringArray parameter;
-    };
-
     CabbageWidgetData() {};
     ~CabbageWidgetData() {};
     //============================================================================
@@ -86,7 +80,6 @@ public:
     static void setProperty (ValueTree widgetData, Identifier name, const var& value);
     static var getProperty (ValueTree widgetData, Identifier name);
     //============================================================================
-    static IdentifiersAndParameters getSetofIdentifiersAndParameters (String lineOfText);
     static var getVarArrayFromTokens (StringArray strTokens);
     static void addFiles (StringArray strToken, ValueTree widgetData, String identifier);
     static void setChannelArrays (StringArray strTokens, ValueTree widgetData, String identifier);
@@ -33,6 +33,7 @@ void CabbageWidgetData::setFormProperties (ValueTree widgetData, int ID)
     setProperty (widgetData, CabbageIdentifierIds::name, "form");
     setProperty (widgetData, CabbageIdentifierIds::type, "form");
     setProperty (widgetData, CabbageIdentifierIds::guirefresh, 128);
+    setProperty (widgetData, CabbageIdentifierIds::idletime, 0);
     setProperty (widgetData, CabbageIdentifierIds::identchannel, "");
     setProperty (widgetData, CabbageIdentifierIds::visible, 1);
     setProperty (widgetData, CabbageIdentifierIds::scrollbars, 0);
@@ -275,6 +276,7 @@ void CabbageWidgetData::setSignalDisplayProperties (ValueTree widgetData, int ID
     setProperty (widgetData, CabbageIdentifierIds::identchannel, "");
     setProperty (widgetData, CabbageIdentifierIds::displaytype, "spectroscope");
     setProperty (widgetData, CabbageIdentifierIds::zoom, 0);
+    setProperty (widgetData, CabbageIdentifierIds::logscale, 0);
     setProperty (widgetData, CabbageIdentifierIds::visible, 1);
 }
 
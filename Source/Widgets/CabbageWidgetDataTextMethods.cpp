@@ -20,17 +20,13 @@
 #include "../Utilities/CabbageUtilities.h"
 #include "../CabbageIds.h"
 #include "CabbageWidgetData.h"
-
-constexpr unsigned long long int HashStringToInt (const char* str, unsigned long long int hash = 0)
-{
-    return (*str == 0) ? hash : 101 * HashStringToInt (str + 1) + *str;
-}
+#include "CabbageLineLexer.h"
 
 //===========================================================================
 // these methods will return Cabbage code based on data stored in widget tree
 String CabbageWidgetData::getCabbageCodeForIdentifier(ValueTree widgetData, String identifier)
 {
-    switch (HashStringToInt (identifier.toStdString().c_str()))
+    switch (CabbageLineLexer::hash (identifier))
     {
         case HashStringToInt ("active"):
         case HashStringToInt ("alpha"):
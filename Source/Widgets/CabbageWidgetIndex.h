@@ -0,0 +1,106 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEWIDGETINDEX_H_INCLUDED
+#define CABBAGEWIDGETINDEX_H_INCLUDED
+
+#include "CabbageWidgetData.h"
+
+//==============================================================================
+// Finds the children of a widget tree by name or by first channel without walking the tree.
+// The index listens to the tree and is rebuilt on the next lookup after a widget is added,
+// removed or moved, or after a name or channel changes, which is what the layout editor does
+// when widgets are edited. Lookups give the same results as
+// CabbageWidgetData::getValueTreeForComponent(), including the first match winning when
+// names repeat.
+//==============================================================================
+class CabbageWidgetIndex : private ValueTree::Listener
+{
+public:
+    CabbageWidgetIndex (ValueTree& widgetsToIndex)
+        : widgets (widgetsToIndex)
+    {
+        widgets.addListener (this);
+    }
+
+    ~CabbageWidgetIndex()
+    {
+        widgets.removeListener (this);
+    }
+
+    ValueTree getWidget (const String& name, bool searchByChannel = false)
+    {
+        const int index = getWidgetIndex (name, searchByChannel);
+        return index >= 0 ? widgets.getChild (index) : ValueTree ("empty");
+    }
+
+    // index of the widget in the tree, or -1 if there isn't one
+    int getWidgetIndex (const String& name, bool searchByChannel = false)
+    {
+        if (! searchByChannel && name == "form")
+            return widgets.getNumChildren() > 0 ? 0 : -1;
+
+        if (needsRebuild)
+            rebuild();
+
+        const HashMap<String, int>& map = searchByChannel ? byChannel : byName;
+        return map.contains (name) ? map[name] : -1;
+    }
+
+private:
+    void rebuild()
+    {
+        byName.clear();
+        byChannel.clear();
+
+        //go backwards so that the first of any widgets sharing a name is the one kept
+        for (int i = widgets.getNumChildren(); --i >= 0;)
+        {
+            const ValueTree widget (widgets.getChild (i));
+            byName.set (widget.getProperty (CabbageIdentifierIds::name).toString(), i);
+
+            const var channels = widget.getProperty (CabbageIdentifierIds::channel);
+
+            if (channels.size() > 0)
+                byChannel.set (channels[0].toString(), i);
+        }
+
+        needsRebuild = false;
+    }
+
+    void valueTreePropertyChanged (ValueTree& tree, const Identifier& property) override
+    {
+        if ((property == CabbageIdentifierIds::name || property == CabbageIdentifierIds::channel) && tree.getParent() == widgets)
+            needsRebuild = true;
+    }
+
+    void valueTreeChildAdded (ValueTree&, ValueTree&) override                  { needsRebuild = true; }
+    void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override           { needsRebuild = true; }
+    void valueTreeChildOrderChanged (ValueTree&, int, int) override             { needsRebuild = true; }
+    void valueTreeParentChanged (ValueTree&) override                           {}
+    void valueTreeRedirected (ValueTree&) override                              { needsRebuild = true; }
+
+    ValueTree& widgets;
+    HashMap<String, int> byName, byChannel;
+    bool needsRebuild = true;
+
+    JUCE_DECLARE_NON_COPYABLE (CabbageWidgetIndex)
+};
+
+#endif  // CABBAGEWIDGETINDEX_H_INCLUDED
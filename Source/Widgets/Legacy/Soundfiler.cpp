@@ -19,6 +19,56 @@
 
 #include "Soundfiler.h"
 
+//==============================================================================
+// persistent thumbnail cache
+//==============================================================================
+CabbageThumbnailCache::CabbageThumbnailCache() : AudioThumbnailCache (32)
+{
+    //keep the disk cache bounded, oldest thumbnails go first
+    Array<File> cacheFiles;
+    getCacheDirectory().findChildFiles (cacheFiles, File::findFiles, false, "*.thumb");
+
+    if (cacheFiles.size() > maxNumCacheFiles)
+    {
+        struct OldestFirst
+        {
+            static int compareElements (const File& first, const File& second)
+            {
+                return first.getLastAccessTime() < second.getLastAccessTime() ? -1 : (first.getLastAccessTime() > second.getLastAccessTime() ? 1 : 0);
+            }
+        };
+
+        OldestFirst sorter;
+        cacheFiles.sort (sorter);
+
+        for (int i = 0; i < cacheFiles.size() - maxNumCacheFiles; i++)
+            cacheFiles[i].deleteFile();
+    }
+}
+
+void CabbageThumbnailCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase& thumb, int64 hashCode)
+{
+    const File cacheFile = getCacheFile (hashCode);
+
+    if (cacheFile.getParentDirectory().createDirectory().wasOk())
+    {
+        FileOutputStream output (cacheFile);
+
+        if (output.openedOk())
+        {
+            output.setPosition (0);
+            output.truncate();
+            thumb.saveTo (output);
+        }
+    }
+}
+
+bool CabbageThumbnailCache::loadNewThumb (AudioThumbnailBase& thumb, int64 hashCode)
+{
+    FileInputStream input (getCacheFile (hashCode));
+    return input.openedOk() && thumb.loadFrom (input);
+}
+
 //==============================================================================
 // zooming button
 //==============================================================================
@@ -55,7 +105,7 @@ public:
 // soundfiler display  component
 //==============================================================================
 
-Soundfiler::Soundfiler (int sr, Colour col, Colour bgcol):   thumbnailCache (5), colour (col),                                                        sampleRate (sr),
+Soundfiler::Soundfiler (int sr, Colour col, Colour bgcol):   colour (col),                                                        sampleRate (sr),
     currentPlayPosition (0),
     mouseDownX (0),
     mouseUpX (0),
@@ -69,7 +119,7 @@ Soundfiler::Soundfiler (int sr, Colour col, Colour bgcol):   thumbnailCache (5),
     currentPositionMarker (new DrawableRectangle())
 {
     formatManager.registerBasicFormats();
-    thumbnail = new AudioThumbnail (2, formatManager, thumbnailCache);
+    thumbnail = new AudioThumbnail (2, formatManager, *thumbnailCache);
     thumbnail->addChangeListener (this);
     //setSize(400, 200);
     sampleRate = sr;
@@ -125,22 +175,30 @@ void Soundfiler::setFile (const File& file)
 {
     if (! file.isDirectory())
     {
-        AudioFormatManager format;
-        format.registerBasicFormats();
-        //registers wav and aif format (just nescearry one time if you alays use the "getInstance()" method)
-        AudioFormatReader* reader = format.createReaderFor (file);
+        //only the header is read here, the audio itself is streamed by the thumbnail
+        ScopedPointer<AudioFormatReader> reader (formatManager.createReaderFor (file));
 
-        //creates a reader for the result file (may file, if the result/opened file is no wav or aif)
         if (reader) //if a reader got created
         {
-            AudioSampleBuffer buffer (reader->numChannels, reader->lengthInSamples);
-            buffer.clear();
-            buffer.setSize (reader->numChannels, reader->lengthInSamples);
-            reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
-            setWaveform (buffer, reader->numChannels);
-        }
+            sampleRate = reader->sampleRate;
+
+            //long files get a coarser thumbnail so its memory use stays bounded
+            const int samplesPerThumbSample = jlimit (2, 512, nextPowerOfTwo ((int) (reader->lengthInSamples / 65536)));
+            reader = nullptr;
 
-        delete reader;
+            thumbnail->removeChangeListener (this);
+            thumbnail = new AudioThumbnail (samplesPerThumbSample, formatManager, *thumbnailCache);
+            thumbnail->addChangeListener (this);
+
+            //peaks come from the disk cache if this file has been seen before, otherwise
+            //they are read on the cache's thread and drawn as they arrive
+            thumbnail->setSource (new FileInputSource (file, true));
+
+            const Range<double> newRange (0.0, thumbnail->getTotalLength());
+            scrollbar->setRangeLimits (newRange);
+            setRange (newRange);
+            setZoomFactor (zoom);
+        }
     }
 
     repaint (0, 0, getWidth(), getHeight());
@@ -152,6 +210,7 @@ void Soundfiler::setWaveform (AudioSampleBuffer buffer, int channels)
     thumbnail->clear();
     repaint();
     thumbnail->reset (channels, 44100, buffer.getNumSamples());
+    sampleRate = 44100;
     //thumbnail->clear();
     thumbnail->addBlock (0, buffer, 0, buffer.getNumSamples());
     const Range<double> newRange (0.0, thumbnail->getTotalLength());
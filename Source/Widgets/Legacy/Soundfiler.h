@@ -23,6 +23,33 @@
 #include "../../CabbageCommonHeaders.h"
 
 class ZoomButton;
+//=================================================================
+// thumbnail cache shared by all soundfilers. Peaks are generated on the
+// cache's background thread and written to disk once complete, keyed on
+// the file's path and modification time, so reopening a file is instant
+//=================================================================
+class CabbageThumbnailCache : public AudioThumbnailCache
+{
+public:
+    CabbageThumbnailCache();
+
+    static File getCacheDirectory()
+    {
+        return File::getSpecialLocation (File::userApplicationDataDirectory).getChildFile ("Cabbage/ThumbnailCache");
+    }
+
+    static const int maxNumCacheFiles = 512;
+
+private:
+    File getCacheFile (int64 hashCode) const
+    {
+        return getCacheDirectory().getChildFile (String::toHexString (hashCode) + ".thumb");
+    }
+
+    void saveNewlyFinishedThumbnail (const AudioThumbnailBase& thumb, int64 hashCode) override;
+    bool loadNewThumb (AudioThumbnailBase& thumb, int64 hashCode) override;
+};
+
 //=================================================================
 // display a sound file as a waveform..
 //=================================================================
@@ -117,7 +144,7 @@ private:
     float sampleRate;
     float regionWidth;
     Image waveformImage;
-    AudioThumbnailCache thumbnailCache;
+    SharedResourcePointer<CabbageThumbnailCache> thumbnailCache;
     ScopedPointer<AudioThumbnail> thumbnail;
     Colour colour, bgColour;
     int mouseDownX, mouseUpX;